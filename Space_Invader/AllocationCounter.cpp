@@ -0,0 +1,64 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+    atomic<uint64_t> allocations{ 0 };
+
+    void* allocate(size_t size) {
+        allocations.fetch_add(1, memory_order_relaxed);
+        return malloc(size ? size : 1);
+    }
+}
+
+uint64_t allocationCount() {
+    return allocations.load(memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+    if (void* memory = allocate(size))
+        return memory;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* memory = allocate(size))
+        return memory;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
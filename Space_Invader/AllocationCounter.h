@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+//Every call to the global operator new in this program bumps a counter, so a stretch of code
+//can be checked for heap allocations by reading it before and after.
+//AllocationCounter.cpp replaces operator new, link it into anything that wants the numbers.
+uint64_t allocationCount();
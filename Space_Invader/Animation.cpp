@@ -0,0 +1,50 @@
+#include "Animation.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace sf;
+
+AnimationClip AnimationClip::strip(const IntRect& sheet, Vector2i frameSize, float frameTime, LoopMode loop) {
+    AnimationClip clip;
+    int count = max(1, sheet.width / frameSize.x);
+    for (int i = 0; i < count; i++) {
+        clip.frames.push_back(IntRect(sheet.left + frameSize.x * i, sheet.top, frameSize.x, frameSize.y));
+        clip.durations.push_back(frameTime);
+    }
+    clip.loop = loop;
+    return clip;
+}
+
+void Animation::play(const AnimationClip& newClip) {
+    clip = &newClip;
+    frame = 0;
+    elapsed = 0.f;
+    active = true;
+}
+
+bool Animation::advance(float deltaTime) {
+    if (!active)
+        return false;
+    elapsed += deltaTime;
+    //A long frame time can skip several frames at once
+    while (elapsed >= clip->durations[frame]) {
+        elapsed -= clip->durations[frame];
+        if (frame + 1u < clip->frameCount())
+            frame++;
+        else if (clip->loop == LoopMode::Loop)
+            frame = 0;
+        else {
+            active = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+void advanceAll(Pool<Animation>& animations, float deltaTime) {
+    animations.forEach([&](Animation& animation, uint32_t index) {
+        if (!animation.advance(deltaTime))
+            animations.release(index);
+    });
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Pool.h"
+
+enum class LoopMode : uint8_t { Once, Loop };
+
+//The frames of one animation as rects inside the atlas, with how long each one stays up.
+//Clips are built once at startup and only read after that, every instance playing one just
+//points at it, so switching animations is a pointer swap and never touches the texture.
+struct AnimationClip {
+    std::vector<sf::IntRect> frames;
+    std::vector<float> durations; //Seconds per frame, same length as frames and above zero
+    LoopMode loop = LoopMode::Once;
+
+    size_t frameCount() const { return frames.size(); }
+
+    //Cuts a horizontal strip into equal frames that all last frameTime
+    static AnimationClip strip(const sf::IntRect& sheet, sf::Vector2i frameSize, float frameTime, LoopMode loop);
+};
+
+//One playing copy of a clip. Small and trivially copyable so a Pool of them stays cheap.
+struct Animation {
+    const AnimationClip* clip = nullptr;
+    sf::Vector2f position;
+    float elapsed = 0.f; //Time spent on the current frame
+    uint16_t frame = 0;
+    bool active = false;
+
+    Animation() {}
+    Animation(const AnimationClip& clip, sf::Vector2f position)
+        : clip(&clip), position(position), active(true) {
+    }
+
+    //Switches to another clip from its first frame
+    void play(const AnimationClip& newClip);
+
+    //Returns false once a clip that doesn't loop has shown its last frame
+    bool advance(float deltaTime);
+
+    const sf::IntRect& frameRect() const { return clip->frames[frame]; }
+};
+
+//Advances every animation in the pool in one pass and frees the ones that finished
+void advanceAll(Pool<Animation>& animations, float deltaTime);
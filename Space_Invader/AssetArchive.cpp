@@ -0,0 +1,261 @@
+#include "AssetArchive.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    const char Magic[4] = { 'S', 'I', 'P', 'K' };
+    const uint16_t Version = 1;
+    const size_t Alignment = 16;
+
+    void writeBytes(vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    //Reads from the mapping, any read past the end sets failed instead of going out of bounds
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+        bool failed = false;
+
+        uint64_t bytes(int count) {
+            if (offset + count > size) {
+                failed = true;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < count; i++)
+                value |= uint64_t(data[offset++]) << (8 * i);
+            return value;
+        }
+    };
+}
+
+AssetArchive::~AssetArchive() {
+    close();
+}
+
+bool AssetArchive::open(const string& path, string& error) {
+    close();
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        error = "can't open " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    mappedSize = size_t(fileSize.QuadPart);
+    mapping = mappedSize ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    mapped = mapping ? static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        error = "can't open " + path;
+        return false;
+    }
+    struct stat info;
+    fstat(descriptor, &info);
+    mappedSize = size_t(info.st_size);
+    void* view = mappedSize ? mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+    ::close(descriptor); //The mapping keeps the file alive on its own
+    mapped = view != MAP_FAILED ? static_cast<const uint8_t*>(view) : nullptr;
+#endif
+    if (!mapped) {
+        close();
+        error = "can't map " + path;
+        return false;
+    }
+
+    Reader reader{ mapped, mappedSize };
+    if (mappedSize < 4 || memcmp(mapped, Magic, 4) != 0) {
+        close();
+        error = path + " isn't an asset archive";
+        return false;
+    }
+    reader.offset = 4;
+    uint16_t version = uint16_t(reader.bytes(2));
+    reader.bytes(2);
+    uint32_t count = uint32_t(reader.bytes(4));
+    if (version != Version) {
+        close();
+        error = path + " is version " + to_string(version) + ", rebuild it with PackAssets";
+        return false;
+    }
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+        size_t length = size_t(reader.bytes(2));
+        if (reader.offset + length > mappedSize) {
+            reader.failed = true;
+            break;
+        }
+        string name(reinterpret_cast<const char*>(mapped + reader.offset), length);
+        reader.offset += length;
+        uint64_t offset = reader.bytes(8);
+        uint64_t size = reader.bytes(8);
+        if (offset > mappedSize || size > mappedSize - offset) {
+            reader.failed = true;
+            break;
+        }
+        entries[name] = { mapped + offset, size_t(size) };
+    }
+    if (reader.failed) {
+        close();
+        error = path + " is truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+bool AssetArchive::openLoose(const string& manifestPath, string& error) {
+    close();
+    vector<ManifestEntry> manifest;
+    if (!readAssetManifest(manifestPath, manifest, error))
+        return false;
+    //Sized up front, the entries point into these
+    looseFiles.resize(manifest.size());
+    for (size_t i = 0; i < manifest.size(); i++) {
+        const ManifestEntry& entry = manifest[i];
+        if (readAssetFile(entry.path, looseFiles[i])) {
+            entries[entry.path] = { looseFiles[i].data(), looseFiles[i].size() };
+            continue;
+        }
+        if (!entry.optional) {
+            close();
+            error = "can't read " + entry.path;
+            return false;
+        }
+        cout << entry.path << " isn't there, skipped\n";
+    }
+    return true;
+}
+
+void AssetArchive::close() {
+    entries.clear();
+    looseFiles.clear();
+#ifdef _WIN32
+    if (mapped)
+        UnmapViewOfFile(mapped);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+    mapping = file = nullptr;
+#else
+    if (mapped)
+        munmap(const_cast<uint8_t*>(mapped), mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+const AssetData* AssetArchive::find(const string& name) const {
+    auto found = entries.find(name);
+    return found == entries.end() ? nullptr : &found->second;
+}
+
+bool readAssetFile(const string& path, vector<uint8_t>& bytes) {
+    ifstream file(path, ios::binary);
+    if (!file)
+        return false;
+    bytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    return true;
+}
+
+//Options come first, whatever is left of the line is the path (they have spaces in them)
+bool readAssetManifest(const string& path, vector<ManifestEntry>& entries, string& error) {
+    ifstream file(path);
+    if (!file) {
+        error = "can't open " + path;
+        return false;
+    }
+    string line;
+    int number = 0;
+    while (getline(file, line)) {
+        number++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        ManifestEntry entry;
+        entry.line = number;
+        size_t start = line.find_first_not_of(" \t");
+        while (start != string::npos && line[start] != '#') {
+            size_t end = line.find_first_of(" \t", start);
+            string word = line.substr(start, end == string::npos ? string::npos : end - start);
+            if (word == "ogg")
+                entry.ogg = true;
+            else if (word == "optional")
+                entry.optional = true;
+            else
+                break;
+            start = end == string::npos ? end : line.find_first_not_of(" \t", end);
+        }
+        if (start == string::npos || line[start] == '#')
+            continue;
+        entry.path = line.substr(start, line.find_last_not_of(" \t") + 1 - start);
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool writeAssetArchive(const string& path, const vector<PackedAsset>& assets, string& error) {
+    vector<uint8_t> index(Magic, Magic + 4);
+    writeBytes(index, Version, 2);
+    writeBytes(index, 0, 2);
+    writeBytes(index, uint32_t(assets.size()), 4);
+
+    //Offsets depend on how long the index is, so add that up first
+    size_t indexSize = index.size();
+    for (const PackedAsset& asset : assets) {
+        if (asset.name.size() > 0xFFFF) {
+            error = "name too long: " + asset.name;
+            return false;
+        }
+        indexSize += 2 + asset.name.size() + 16;
+    }
+    size_t offset = indexSize;
+    for (const PackedAsset& asset : assets) {
+        offset = (offset + Alignment - 1) / Alignment * Alignment;
+        writeBytes(index, asset.name.size(), 2);
+        index.insert(index.end(), asset.name.begin(), asset.name.end());
+        writeBytes(index, offset, 8);
+        writeBytes(index, asset.bytes.size(), 8);
+        offset += asset.bytes.size();
+    }
+
+    ofstream file(path, ios::binary);
+    if (!file) {
+        error = "can't write " + path;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(index.data()), index.size());
+    const char padding[Alignment] = {};
+    size_t written = index.size();
+    for (const PackedAsset& asset : assets) {
+        size_t aligned = (written + Alignment - 1) / Alignment * Alignment;
+        file.write(padding, aligned - written);
+        file.write(reinterpret_cast<const char*>(asset.bytes.data()), asset.bytes.size());
+        written = aligned + asset.bytes.size();
+    }
+    if (!file) {
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Every asset the game loads lives in one file (Resources.pak, built by PackAssets from
+//Resources/assets.txt). The file is memory mapped and each asset is handed to SFML's
+//loadFromMemory / openFromMemory where it sits, so nothing gets read twice or copied.
+//
+//File layout, all little endian:
+//    "SIPK", u16 version, u16 flags (0), u32 entry count
+//    then per entry: u16 name length, name, u64 offset, u64 size
+//    then the data, each entry starting on a 16 byte boundary
+//Names are the paths the game already asks for, like "Resources/Sounds/Menu.wav".
+//
+//Builds that never ran PackAssets (the Visual Studio project) can openLoose() the manifest
+//instead, which reads the same files straight out of Resources/ into memory.
+
+struct AssetData {
+    const void* data;
+    size_t size;
+};
+
+class AssetArchive {
+public:
+    AssetArchive() = default;
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+    ~AssetArchive();
+
+    //Maps the file and reads the index. On failure error says what was wrong.
+    bool open(const std::string& path, std::string& error);
+    //Reads every file the manifest lists, under the same names. Optional ones may be missing.
+    bool openLoose(const std::string& manifestPath, std::string& error);
+    void close();
+
+    //nullptr when the archive doesn't have it. The pointer and the bytes stay valid until close().
+    const AssetData* find(const std::string& name) const;
+    size_t size() const { return entries.size(); }
+    size_t bytes() const { return mappedSize; }
+
+private:
+    const uint8_t* mapped = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+    std::vector<std::vector<uint8_t>> looseFiles; //Owns the bytes when opened loose
+    std::unordered_map<std::string, AssetData> entries;
+};
+
+//One line of Resources/assets.txt: "[ogg] [optional] <path>"
+struct ManifestEntry {
+    std::string path;
+    bool ogg = false; //Re-encoded while packing
+    bool optional = false; //Skipped with a warning when missing
+    int line = 0;
+};
+
+bool readAssetManifest(const std::string& path, std::vector<ManifestEntry>& entries, std::string& error);
+bool readAssetFile(const std::string& path, std::vector<uint8_t>& bytes);
+
+//What PackAssets writes, one per asset in manifest order
+struct PackedAsset {
+    std::string name;
+    std::vector<uint8_t> bytes;
+};
+
+bool writeAssetArchive(const std::string& path, const std::vector<PackedAsset>& assets, std::string& error);
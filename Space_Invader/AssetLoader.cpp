@@ -0,0 +1,202 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+using namespace sf;
+
+AssetLoader::AssetLoader(const AssetArchive& archive)
+    : archive(archive) {
+}
+
+AssetLoader::~AssetLoader() {
+    //Nothing left to hand out, the workers finish whatever they're decoding and stop
+    nextJob = jobs.size();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void AssetLoader::add(Kind kind, const string& name, const string& path, AssetGroup group, Music* music, bool optional) {
+    Job job;
+    job.kind = kind;
+    job.name = name;
+    job.path = path;
+    job.group = group;
+    job.music = music;
+    job.optional = optional;
+    jobs.push_back(job);
+    pending[size_t(group)]++;
+    if (kind == Kind::Image)
+        pendingImages++;
+    if (kind == Kind::Font)
+        pendingFonts++;
+}
+
+void AssetLoader::addImage(const string& name, const string& path, AssetGroup group) {
+    add(Kind::Image, name, path, group);
+}
+
+void AssetLoader::addFont(const string& path, AssetGroup group) {
+    add(Kind::Font, path, path, group);
+}
+
+void AssetLoader::addSound(const string& path, AssetGroup group) {
+    add(Kind::Sound, path, path, group);
+}
+
+void AssetLoader::addMusic(Music& music, const string& path, AssetGroup group, bool optional) {
+    add(Kind::Music, path, path, group, &music, optional);
+}
+
+void AssetLoader::addGlyphs(GlyphAtlas& glyphs, const string& fontPath, const vector<unsigned>& sizes) {
+    glyphRequests.push_back({ &glyphs, fontPath, sizes });
+}
+
+bool AssetLoader::start(unsigned threads) {
+    //Everything is checked against the index up front, a missing asset stops the game here
+    //instead of showing up later as a blank sprite or a silent sound
+    bool complete = true;
+    for (Job& job : jobs) {
+        job.asset = archive.find(job.path);
+        if (!job.asset && job.optional)
+            cout << "Not in the asset archive, skipping " << job.path << "\n";
+        else if (!job.asset) {
+            cout << "Missing from the asset archive: " << job.path << "\n";
+            complete = false;
+        }
+    }
+    if (!complete)
+        return false;
+
+    if (threads == 0)
+        threads = max(2u, thread::hardware_concurrency()) - 1; //hardware_concurrency() is 0 when it can't tell
+    threads = unsigned(min<size_t>(threads, jobs.size()));
+    clock.restart();
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(&AssetLoader::work, this);
+    return true;
+}
+
+void AssetLoader::work() {
+    //Jobs are claimed in queue order, so the menu's assets are decoded first
+    for (size_t index = nextJob++; index < jobs.size(); index = nextJob++) {
+        Job& job = jobs[index];
+        auto begin = chrono::steady_clock::now();
+        //Straight from the mapping, the bytes are never copied out of it
+        const void* data = job.asset ? job.asset->data : nullptr;
+        size_t size = job.asset ? job.asset->size : 0;
+        switch (job.kind) {
+        case Kind::Image:
+            job.image = make_shared<Image>();
+            job.loaded = job.image->loadFromMemory(data, size);
+            break;
+        case Kind::Font:
+            job.font = make_shared<Font>();
+            job.loaded = job.font->loadFromMemory(data, size);
+            break;
+        case Kind::Sound:
+            job.sound = make_shared<SoundBuffer>();
+            job.loaded = job.sound->loadFromMemory(data, size);
+            break;
+        case Kind::Music:
+            job.loaded = data && job.music->openFromMemory(data, size);
+            break;
+        }
+        job.decodeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        lock_guard<mutex> guard(finishedLock);
+        finished.push_back(index);
+    }
+}
+
+void AssetLoader::poll(Resources& resources, TextureAtlas& atlas) {
+    vector<size_t> batch;
+    {
+        lock_guard<mutex> guard(finishedLock);
+        batch.swap(finished);
+    }
+
+    for (size_t index : batch) {
+        Job& job = jobs[index];
+        job.readyMs = clock.getElapsedTime().asMicroseconds() / 1000.0;
+        if (!job.loaded && job.asset)
+            cout << "Failed to decode " << job.path << "\n";
+
+        switch (job.kind) {
+        case Kind::Image:
+            //The atlas can only be packed once it has every image
+            decodedImages.push_back(index);
+            pendingImages--;
+            continue;
+        case Kind::Font:
+            resources.fonts.insert(job.path, job.font);
+            job.font.reset();
+            pendingFonts--;
+            break;
+        case Kind::Sound:
+            resources.sounds.insert(job.path, job.sound);
+            job.sound.reset();
+            break;
+        case Kind::Music:
+            break;
+        }
+        pending[size_t(job.group)]--;
+        handedOver++;
+    }
+
+    if (pendingImages == 0 && pendingFonts == 0 && !decodedImages.empty()) {
+        //Add in queue order so the packing doesn't depend on which thread finished first
+        sort(decodedImages.begin(), decodedImages.end());
+        for (size_t index : decodedImages) {
+            Job& job = jobs[index];
+            atlas.add(job.name, *job.image);
+            job.image.reset();
+            pending[size_t(job.group)]--;
+            handedOver++;
+        }
+        decodedImages.clear();
+        for (const auto& request : glyphRequests) {
+            if (auto font = resources.fonts.get(request.fontPath))
+                request.glyphs->add(*font, request.sizes, atlas);
+        }
+        if (!atlas.build())
+            cout << "Failed to build the texture atlas\n";
+        for (const auto& request : glyphRequests)
+            request.glyphs->resolve(atlas);
+    }
+}
+
+bool AssetLoader::ready(AssetGroup group) const {
+    return pending[size_t(group)] == 0;
+}
+
+bool AssetLoader::done() const {
+    return handedOver == jobs.size();
+}
+
+float AssetLoader::progress() const {
+    return jobs.empty() ? 1.f : float(handedOver) / jobs.size();
+}
+
+void AssetLoader::printTimings(ostream& out) const {
+    vector<const Job*> sorted;
+    double total = 0.0;
+    for (const Job& job : jobs) {
+        sorted.push_back(&job);
+        total += job.decodeMs;
+    }
+    sort(sorted.begin(), sorted.end(), [](const Job* a, const Job* b) {
+        return a->decodeMs > b->decodeMs;
+    });
+
+    char line[256];
+    out << "Asset timings (decode ms, ready at ms):\n";
+    for (const Job* job : sorted) {
+        snprintf(line, sizeof(line), "  %8.2f %8.2f  %s\n", job->decodeMs, job->readyMs, job->path.c_str());
+        out << line;
+    }
+    snprintf(line, sizeof(line), "  %8.2f ms of decoding on %u threads\n", total, unsigned(workers.size()));
+    out << line;
+}
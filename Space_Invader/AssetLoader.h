@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+#include "AssetArchive.h"
+#include "BatchText.h"
+#include "ResourceCache.h"
+#include "TextureAtlas.h"
+
+//What has to be loaded before a part of the game can run
+enum class AssetGroup {
+    Menu, //Needed to show and use the menu
+    Game, //Only needed once a level starts
+    Count
+};
+
+//Decodes the startup assets on a few worker threads while the main thread keeps the window
+//alive. Anything that touches the GPU (packing and uploading the atlas) or the caches happens
+//in poll() on the main thread, as decodes finish.
+//
+//Paths name entries in the archive, which has to outlive the loader and everything it loads
+//(fonts and music keep reading from the mapping).
+class AssetLoader {
+public:
+    explicit AssetLoader(const AssetArchive& archive);
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader();
+
+    //Queue everything before start(), in the order it should be decoded
+    void addImage(const std::string& name, const std::string& path, AssetGroup group);
+    void addFont(const std::string& path, AssetGroup group);
+    void addSound(const std::string& path, AssetGroup group);
+    //Music streams from the archive, so this only reads its header. Optional music that isn't
+    //in the archive is skipped and the sf::Music is left closed.
+    void addMusic(sf::Music& music, const std::string& path, AssetGroup group, bool optional = false);
+
+    //Copies the font's glyphs at these sizes into the atlas just before it's packed. The font has
+    //to be queued with addFont(), and the glyphs are usable once the font's group is ready.
+    void addGlyphs(GlyphAtlas& glyphs, const std::string& fontPath, const std::vector<unsigned>& sizes);
+
+    //0 threads means one per core, leaving one for the main thread. Returns false without
+    //starting anything when the archive is missing an asset that was asked for.
+    bool start(unsigned threads = 0);
+
+    //Hands finished decodes to the caches. Once every image and font is in, the atlas gets packed and uploaded.
+    void poll(Resources& resources, TextureAtlas& atlas);
+
+    bool ready(AssetGroup group) const;
+    bool done() const;
+    float progress() const; //0 to 1, counting only what poll() has already handed over
+
+    //How long each asset took to decode, slowest first
+    void printTimings(std::ostream& out) const;
+
+private:
+    enum class Kind { Image, Font, Sound, Music };
+
+    struct Job {
+        Kind kind;
+        std::string name, path;
+        AssetGroup group;
+        sf::Music* music = nullptr;
+        bool optional = false;
+        const AssetData* asset = nullptr; //Found by start(), null for a skipped optional one
+
+        std::shared_ptr<sf::Image> image;
+        std::shared_ptr<sf::Font> font;
+        std::shared_ptr<sf::SoundBuffer> sound;
+        bool loaded = false;
+        double decodeMs = 0.0;
+        double readyMs = 0.0; //Since start(), when poll() picked it up
+    };
+
+    void add(Kind kind, const std::string& name, const std::string& path, AssetGroup group, sf::Music* music = nullptr, bool optional = false);
+    void work();
+
+    const AssetArchive& archive;
+    std::vector<Job> jobs;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextJob{ 0 };
+
+    std::mutex finishedLock;
+    std::vector<size_t> finished; //Decoded by a worker, waiting for poll()
+
+    struct GlyphRequest {
+        GlyphAtlas* glyphs;
+        std::string fontPath;
+        std::vector<unsigned> sizes;
+    };
+    std::vector<GlyphRequest> glyphRequests;
+
+    size_t handedOver = 0;
+    size_t pendingImages = 0;
+    size_t pendingFonts = 0; //Glyphs are rendered from them, so the atlas waits for these too
+    size_t pending[size_t(AssetGroup::Count)] = {};
+    std::vector<size_t> decodedImages;
+    sf::Clock clock;
+};
@@ -0,0 +1,66 @@
+#include "Autopilot.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    const float DodgeHeight = 140.f; //How far above the ship a bullet starts counting as a threat
+    const float AimTolerance = 4.f;
+}
+
+InputFrame autopilot(const GameSimulation& sim) {
+    return autopilot(sim, sim.player);
+}
+
+InputFrame autopilot(const GameSimulation& sim, const PlayerShip& ship) {
+    InputFrame input;
+    if (ship.position.y < 0.f) //Waiting to respawn
+        return input;
+
+    Box bounds = ship.getBounds();
+    float center = bounds.left + bounds.width / 2;
+
+    //Get out from under anything about to hit us
+    const BulletStore& bullets = sim.bullets;
+    for (uint32_t i = 0; i < bullets.slots.slots(); i++) {
+        if (!bullets.slots.alive[i] || bullets.playerOrigin[i])
+            continue;
+        Box bullet = bullets.getBounds(i);
+        bool above = bullet.top + bullet.height > bounds.top - DodgeHeight && bullet.top < bounds.top + bounds.height;
+        bool inLine = bullet.left + bullet.width > bounds.left - 8.f && bullet.left < bounds.left + bounds.width + 8.f;
+        if (above && inLine && ship.invulnerability <= 0.f) {
+            bool goLeft = bullet.left + bullet.width / 2 > center;
+            //Walls don't move, so turn around if there's no room
+            if (goLeft && ship.position.x <= 40.f)
+                goLeft = false;
+            else if (!goLeft && ship.position.x >= 640.f)
+                goLeft = true;
+            input.left = goLeft;
+            input.right = !goLeft;
+            return input;
+        }
+    }
+
+    //Line our bullet up with the closest enemy
+    float muzzle = ship.position.x + 17.f + BulletStore::Size / 2.f;
+    const EnemyStore& enemies = sim.enemies;
+    float bestOffset = 0.f;
+    bool found = false;
+    for (uint32_t i = 0; i < enemies.slots.slots(); i++) {
+        if (!enemies.slots.alive[i])
+            continue;
+        Box hitbox = enemies.getHitbox(i);
+        float offset = hitbox.left + hitbox.width / 2 - muzzle;
+        if (!found || fabs(offset) < fabs(bestOffset)) {
+            bestOffset = offset;
+            found = true;
+        }
+    }
+    if (found) {
+        input.left = bestOffset < -AimTolerance;
+        input.right = bestOffset > AimTolerance;
+    }
+    input.fire = true;
+    return input;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "GameSimulation.h"
+
+//A simple bot that plays the simulation: it lines up under the nearest enemy and fires,
+//and sidesteps enemy bullets that are about to land on it. Good enough to get through the
+//levels headless, so full runs can be recorded and replayed without a person at the keyboard.
+InputFrame autopilot(const GameSimulation& sim);
+//Same for any ship, so both sides of a co-op run can be played headless
+InputFrame autopilot(const GameSimulation& sim, const PlayerShip& ship);
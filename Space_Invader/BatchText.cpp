@@ -0,0 +1,124 @@
+#include "BatchText.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    string pageName(unsigned size) {
+        return "Glyphs" + to_string(size);
+    }
+}
+
+void GlyphAtlas::add(const Font& font, const vector<unsigned>& sizes, TextureAtlas& atlas) {
+    for (unsigned size : sizes) {
+        Page& page = pages[size];
+        page.lineSpacing = font.getLineSpacing(size);
+        int used = 1;
+        for (char c = FirstChar; c <= LastChar; c++) {
+            const sf::Glyph& source = font.getGlyph(Uint32(c), size, false);
+            page.glyphs[c - FirstChar] = { source.textureRect, Vector2f(source.bounds.left, source.bounds.top), source.advance };
+            used = max(used, source.textureRect.top + source.textureRect.height);
+        }
+        //The font's page is usually much taller than what got filled, only the used part goes in the atlas
+        Image full = font.getTexture(size).copyToImage();
+        Image trimmed;
+        trimmed.create(full.getSize().x, unsigned(used), Color::Transparent);
+        trimmed.copy(full, 0, 0, IntRect(0, 0, int(full.getSize().x), used));
+        atlas.add(pageName(size), trimmed);
+    }
+}
+
+void GlyphAtlas::resolve(const TextureAtlas& atlas) {
+    for (auto& entry : pages) {
+        IntRect region = atlas.region(pageName(entry.first));
+        for (Glyph& glyph : entry.second.glyphs) {
+            glyph.rect.left += region.left;
+            glyph.rect.top += region.top;
+        }
+    }
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::glyph(unsigned size, char c) const {
+    const Page& page = pages.at(size);
+    if (c < FirstChar || c > LastChar)
+        c = ' ';
+    return page.glyphs[c - FirstChar];
+}
+
+float GlyphAtlas::lineSpacing(unsigned size) const {
+    return pages.at(size).lineSpacing;
+}
+
+TextRun::TextRun(const GlyphAtlas& glyphs, unsigned size, const string& text, Vector2f position)
+    : glyphs(&glyphs), size(size), position(position) {
+    setString(text);
+}
+
+//Same layout as sf::Text: the first baseline sits size pixels below the position.
+//PressStart2P is monospaced so kerning is left out.
+void TextRun::setString(const string& text) {
+    quads.clear();
+    right = 0.f;
+    Vector2f pen(0.f, float(size));
+    for (char c : text) {
+        if (c == '\n') {
+            pen.x = 0.f;
+            pen.y += glyphs->lineSpacing(size);
+            continue;
+        }
+        const GlyphAtlas::Glyph& glyph = glyphs->glyph(size, c);
+        if (glyph.rect.width > 0 && glyph.rect.height > 0)
+            quads.push_back({ glyph.rect, pen + glyph.offset });
+        pen.x += glyph.advance;
+        right = max(right, pen.x);
+    }
+}
+
+void TextRun::draw(SpriteBatch& batch) const {
+    for (const Quad& quad : quads)
+        batch.draw(quad.rect, position + quad.offset, color);
+}
+
+NumberField::NumberField(const GlyphAtlas& glyphs, unsigned size, Vector2f position, int value)
+    : glyphs(&glyphs), size(size), position(position), value(value + 1) {
+    set(value);
+}
+
+void NumberField::set(int newValue) {
+    if (newValue == value && length > 0)
+        return;
+    value = newValue;
+
+    //Digits come out backwards, then get flipped into place
+    char text[MaxDigits];
+    int count = 0;
+    unsigned magnitude = newValue < 0 ? 0u - unsigned(newValue) : unsigned(newValue);
+    do {
+        text[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (newValue < 0)
+        text[count++] = '-';
+    reverse(text, text + count);
+
+    //Characters before the first change keep their quads, the rest are redone since a different width would move them
+    int first = 0;
+    while (first < count && first < length && digits[first].c == text[first])
+        first++;
+    float pen = 0.f;
+    for (int i = 0; i < first; i++)
+        pen += glyphs->glyph(size, digits[i].c).advance;
+    for (int i = first; i < count; i++) {
+        const GlyphAtlas::Glyph& glyph = glyphs->glyph(size, text[i]);
+        digits[i] = { text[i], glyph.rect, Vector2f(pen, float(size)) + glyph.offset };
+        pen += glyph.advance;
+    }
+    length = count;
+}
+
+void NumberField::draw(SpriteBatch& batch) const {
+    for (int i = 0; i < length; i++)
+        batch.draw(digits[i].rect, position + digits[i].offset, color);
+}
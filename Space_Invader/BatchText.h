@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+
+//Text drawn from glyph quads in the sprite atlas, so the HUD and the menus go into the same
+//batch as the sprites instead of an sf::Text (and a texture switch) each.
+
+//Printable ASCII of one font at a few fixed sizes. The font's glyph pages get copied into the
+//sprite atlas once at load time, after that a glyph is just a rect.
+class GlyphAtlas {
+public:
+    static const char FirstChar = ' ';
+    static const char LastChar = '~';
+
+    struct Glyph {
+        sf::IntRect rect; //In the atlas once resolve() has run
+        sf::Vector2f offset; //From the pen position on the baseline to the quad's top left
+        float advance;
+    };
+
+    //Rasterises the glyphs and queues their pages, call before atlas.build()
+    void add(const sf::Font& font, const std::vector<unsigned>& sizes, TextureAtlas& atlas);
+    //Moves the glyph rects to where the pages were packed, call after atlas.build()
+    void resolve(const TextureAtlas& atlas);
+
+    bool has(unsigned size) const { return pages.count(size) != 0; }
+    //Characters outside the printable range come out as a space
+    const Glyph& glyph(unsigned size, char c) const;
+    float lineSpacing(unsigned size) const;
+
+private:
+    struct Page {
+        std::array<Glyph, LastChar - FirstChar + 1> glyphs;
+        float lineSpacing;
+    };
+    std::map<unsigned, Page> pages;
+};
+
+//A string laid out once into quads, redone only when setString() is called
+class TextRun {
+public:
+    sf::Color color = sf::Color::White;
+
+    TextRun(const GlyphAtlas& glyphs, unsigned size, const std::string& text, sf::Vector2f position);
+
+    void setString(const std::string& text); //Reuses the quads, doesn't allocate unless the text grew
+    void setPosition(sf::Vector2f newPosition) { position = newPosition; }
+    float width() const { return right; }
+    void draw(SpriteBatch& batch) const;
+
+private:
+    struct Quad {
+        sf::IntRect rect;
+        sf::Vector2f offset; //From position
+    };
+    const GlyphAtlas* glyphs;
+    unsigned size;
+    sf::Vector2f position;
+    std::vector<Quad> quads;
+    float right = 0.f;
+};
+
+//A number that changes often (score, lives). Formatting is done by hand into a fixed buffer and
+//only the digits that differ from the last value get new quads, so set() never allocates.
+class NumberField {
+public:
+    static const int MaxDigits = 11; //Sign and ten digits covers any int
+
+    sf::Color color = sf::Color::White;
+
+    NumberField(const GlyphAtlas& glyphs, unsigned size, sf::Vector2f position, int value = 0);
+
+    void set(int value);
+    int get() const { return value; }
+    void setPosition(sf::Vector2f newPosition) { position = newPosition; }
+    void draw(SpriteBatch& batch) const;
+
+private:
+    struct Digit {
+        char c;
+        sf::IntRect rect;
+        sf::Vector2f offset;
+    };
+    const GlyphAtlas* glyphs;
+    unsigned size;
+    sf::Vector2f position;
+    int value;
+    int length = 0;
+    std::array<Digit, MaxDigits> digits;
+};
@@ -0,0 +1,42 @@
+//Runs the simulation headless and counts heap allocations once it has warmed up.
+//The stores, the collision grid and the event list all keep their capacity between ticks,
+//so after the first level is spawned a tick should never allocate. Exits with 1 if one does.
+//
+//Build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/AllocationCheck.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp AllocationCounter.cpp -o AllocationCheck
+
+#include <cstdio>
+
+#include "AllocationCounter.h"
+#include "GameSimulation.h"
+
+int main() {
+    const int WarmupTicks = 2 * TickRate;
+    const int MeasuredTicks = 60 * TickRate;
+
+    GameSimulation sim(1234);
+    sim.start(1, 0.f);
+
+    //Sweep back and forth firing the whole time, so bullets, kills and hits all happen
+    auto inputFor = [](int tick) {
+        InputFrame input;
+        input.left = (tick / 240) % 2 == 0;
+        input.right = !input.left;
+        input.fire = true;
+        return input;
+    };
+
+    int tick = 0;
+    for (; tick < WarmupTicks && sim.playing(); tick++)
+        sim.step(inputFor(tick));
+
+    uint64_t before = allocationCount();
+    int measured = 0;
+    for (; measured < MeasuredTicks && sim.playing(); measured++, tick++)
+        sim.step(inputFor(tick));
+    uint64_t allocations = allocationCount() - before;
+
+    printf("%d ticks measured (level %d, score %d, %u bullets live), %llu allocations\n",
+        measured, sim.level, sim.global_score, sim.bullets.slots.live, (unsigned long long)allocations);
+    return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+//Plays thousands of headless games with the autopilot over a grid of Tuning values, spread over
+//every core, and writes one CSV row per grid point: win rate, survival time, score and kills and
+//deaths per level. Run i of every grid point uses the same seed, so the points differ only in
+//the tuning and not in their luck.
+//
+//    BalanceSweep [--runs N] [--seed N] [--threads N] [--level N] [--minutes N] [--levels file]
+//                 [--difficulty 10,20,30] [--fire 0.5,1,2] [--health 0,1] [--out balance.csv]
+//
+//--difficulty is Tuning::difficultyPerKill, --fire is fireRateScale and --health is extraHealth,
+//each takes a comma separated list. --levels plays a level file instead of the built in levels,
+//which is how per level health gets tried out. Runs still alive after --minutes of game time
+//count as timeouts.
+//
+//Build with the CMake project in the repository root, or from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/BalanceSweep.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp Autopilot.cpp -o BalanceSweep
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Autopilot.h"
+#include "GameSimulation.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+namespace {
+    //Levels past this are counted with the last one
+    const int TrackedLevels = 8;
+
+    struct RunResult {
+        uint64_t ticks = 0;
+        bool won = false, lost = false;
+        int level = 0, score = 0;
+        uint32_t kills[TrackedLevels] = {};
+        uint32_t deaths[TrackedLevels] = {};
+    };
+
+    //splitmix64, so neighbouring run numbers still get unrelated seeds
+    uint64_t runSeed(uint64_t base, uint64_t run) {
+        uint64_t z = base + 0x9E3779B97F4A7C15ull * (run + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    RunResult play(const Tuning& tuning, uint64_t seed, int level, const shared_ptr<const LevelSet>& levels, uint64_t maxTicks) {
+        GameSimulation sim(seed);
+        sim.tuning = tuning;
+        sim.setLevels(levels);
+        sim.start(level, GameStartIntroTime);
+        RunResult result;
+        while (sim.playing() && sim.tick < maxTicks) {
+            sim.step(autopilot(sim));
+            int slot = min(sim.level, TrackedLevels) - 1;
+            for (const GameEvent& e : sim.events) {
+                if (e.type == GameEvent::EnemyKilled)
+                    result.kills[slot]++;
+                else if (e.type == GameEvent::PlayerHit)
+                    result.deaths[slot]++;
+            }
+        }
+        result.ticks = sim.tick;
+        result.won = sim.game_win;
+        result.lost = sim.game_over;
+        result.level = sim.level;
+        result.score = sim.global_score;
+        return result;
+    }
+
+    vector<double> parseList(const char* text) {
+        vector<double> values;
+        string list = text;
+        size_t begin = 0;
+        while (begin <= list.size()) {
+            size_t end = min(list.find(',', begin), list.size());
+            if (end > begin)
+                values.push_back(atof(list.substr(begin, end - begin).c_str()));
+            begin = end + 1;
+        }
+        return values;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int runs = 1000;
+    uint64_t seed = 1;
+    unsigned threads = 0;
+    int level = 1;
+    double minutes = 15;
+    string levelsPath, outPath = "balance.csv";
+    Tuning defaults;
+    vector<double> difficulties = { double(defaults.difficultyPerKill) };
+    vector<double> fireScales = { defaults.fireRateScale };
+    vector<double> healths = { double(defaults.extraHealth) };
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i];
+        const char* value = argv[i + 1];
+        if (option == "--runs") runs = max(1, atoi(value));
+        else if (option == "--seed") seed = strtoull(value, nullptr, 10);
+        else if (option == "--threads") threads = unsigned(max(0, atoi(value)));
+        else if (option == "--level") level = atoi(value);
+        else if (option == "--minutes") minutes = atof(value);
+        else if (option == "--levels") levelsPath = value;
+        else if (option == "--difficulty") difficulties = parseList(value);
+        else if (option == "--fire") fireScales = parseList(value);
+        else if (option == "--health") healths = parseList(value);
+        else if (option == "--out") outPath = value;
+        else {
+            printf("unknown option %s\n", option.c_str());
+            return 2;
+        }
+    }
+    if (difficulties.empty() || fireScales.empty() || healths.empty()) {
+        printf("every grid needs at least one value\n");
+        return 2;
+    }
+
+    shared_ptr<const LevelSet> levels = defaultLevels();
+    if (!levelsPath.empty()) {
+        auto loaded = make_shared<LevelSet>();
+        string error;
+        if (!loaded->load(levelsPath, error)) {
+            printf("Couldn't load %s: %s\n", levelsPath.c_str(), error.c_str());
+            return 1;
+        }
+        levels = loaded;
+    }
+    int lastLevel = min(levels->lastLevel(), TrackedLevels);
+
+    vector<Tuning> grid;
+    for (double difficulty : difficulties)
+        for (double fire : fireScales)
+            for (double health : healths) {
+                Tuning tuning;
+                tuning.difficultyPerKill = int(difficulty);
+                tuning.fireRateScale = float(fire);
+                tuning.extraHealth = int(health);
+                grid.push_back(tuning);
+            }
+
+    //Every game is one job, results go to its own slot so the CSV doesn't depend on the thread count
+    JobSystem jobs(threads);
+    uint64_t maxTicks = uint64_t(minutes * 60 * TickRate);
+    uint32_t total = uint32_t(grid.size()) * uint32_t(runs);
+    vector<RunResult> results(total);
+    printf("%zu grid points x %d runs on %u threads, up to %.0f minutes of game each\n", grid.size(), runs, jobs.threadCount(), minutes);
+
+    auto begin = chrono::steady_clock::now();
+    jobs.parallelFor(total, 1, [&](uint32_t first, uint32_t end) {
+        for (uint32_t i = first; i < end; i++)
+            results[i] = play(grid[i / runs], runSeed(seed, i % runs), level, levels, maxTicks);
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    FILE* out = fopen(outPath.c_str(), "w");
+    if (!out) {
+        printf("Couldn't write %s\n", outPath.c_str());
+        return 1;
+    }
+    fprintf(out, "difficulty_per_kill,fire_rate_scale,extra_health,runs,win_rate,loss_rate,timeout_rate,mean_survival_s,median_survival_s,mean_score,mean_level");
+    for (int l = 1; l <= lastLevel; l++)
+        fprintf(out, ",kills_level%d", l);
+    for (int l = 1; l <= lastLevel; l++)
+        fprintf(out, ",deaths_level%d", l);
+    fprintf(out, "\n");
+
+    uint64_t totalTicks = 0;
+    vector<uint64_t> survival(runs);
+    for (size_t point = 0; point < grid.size(); point++) {
+        const RunResult* first = &results[point * runs];
+        int wins = 0, losses = 0;
+        double score = 0, levelReached = 0, survived = 0;
+        double kills[TrackedLevels] = {}, deaths[TrackedLevels] = {};
+        for (int r = 0; r < runs; r++) {
+            const RunResult& run = first[r];
+            wins += run.won;
+            losses += run.lost;
+            score += run.score;
+            levelReached += run.level;
+            survived += run.ticks;
+            survival[r] = run.ticks;
+            totalTicks += run.ticks;
+            for (int l = 0; l < TrackedLevels; l++) {
+                kills[l] += run.kills[l];
+                deaths[l] += run.deaths[l];
+            }
+        }
+        nth_element(survival.begin(), survival.begin() + runs / 2, survival.end());
+        const Tuning& tuning = grid[point];
+        fprintf(out, "%d,%g,%d,%d,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.3f", tuning.difficultyPerKill, tuning.fireRateScale, tuning.extraHealth, runs,
+            double(wins) / runs, double(losses) / runs, double(runs - wins - losses) / runs, survived / runs * TickDuration,
+            survival[runs / 2] * TickDuration, score / runs, levelReached / runs);
+        for (int l = 0; l < lastLevel; l++)
+            fprintf(out, ",%.2f", kills[l] / runs);
+        for (int l = 0; l < lastLevel; l++)
+            fprintf(out, ",%.3f", deaths[l] / runs);
+        fprintf(out, "\n");
+    }
+    fclose(out);
+
+    double gameSeconds = totalTicks * TickDuration;
+    printf("%u games, %.0f hours of game in %.2f s: %.0fx real time, %.0fx per thread\n", total, gameSeconds / 3600, seconds,
+        gameSeconds / seconds, gameSeconds / seconds / jobs.threadCount());
+    printf("Wrote %s\n", outPath.c_str());
+    return 0;
+}
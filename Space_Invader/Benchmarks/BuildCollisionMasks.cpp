@@ -0,0 +1,140 @@
+//Writes CollisionMaskData.cpp from the alpha of the sprites that can be hit. A pixel counts as
+//solid from half opacity up, so soft edges don't. Run it from the Space_Invader folder whenever
+//one of the images below changes:
+//
+//    BuildCollisionMasks CollisionMaskData.cpp
+//
+//Needs SFML to read the PNGs, the CMake project builds it along with the game.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+using namespace std;
+
+namespace {
+    const sf::Uint8 AlphaThreshold = 128;
+
+    struct Source {
+        const char* name; //Of the constant in the generated file
+        const char* image;
+        int frameWidth; //Animation strips get one mask per frame
+        int frame;
+    };
+
+    const Source Sources[] = {
+        { "Enemy1_1", "Enemy1_1", 50, 0 }, { "Enemy1", "Enemy1", 50, 0 },
+        { "Enemy2_1", "Enemy2_1", 50, 0 }, { "Enemy2", "Enemy2", 50, 0 },
+        { "Enemy3_1", "Enemy3_1", 50, 0 }, { "Enemy3", "Enemy3", 50, 0 },
+        { "ShipStraight0", "player_animation", 50, 0 }, { "ShipStraight1", "player_animation", 50, 1 },
+        { "ShipStraight2", "player_animation", 50, 2 },
+        { "ShipLeft0", "Player_Turning_Animation_Left", 42, 0 }, { "ShipLeft1", "Player_Turning_Animation_Left", 42, 1 },
+        { "ShipLeft2", "Player_Turning_Animation_Left", 42, 2 },
+        { "ShipRight0", "Player_Turning_Animation_Right", 42, 0 }, { "ShipRight1", "Player_Turning_Animation_Right", 42, 1 },
+        { "ShipRight2", "Player_Turning_Animation_Right", 42, 2 },
+        { "EnemyBullet", "EnemyBullet", 16, 0 },
+        { "PlayerBullet", "PlayerBullet", 16, 0 }
+    };
+
+    struct Mask {
+        int width = 0, height = 0;
+        int left = 0, top = 0, right = 0, bottom = 0; //Solid pixels, right and bottom exclusive
+        vector<uint64_t> rows;
+    };
+
+    bool build(const Source& source, Mask& mask) {
+        sf::Image image;
+        string path = string("Resources/Images/") + source.image + ".png";
+        if (!image.loadFromFile(path))
+            return false;
+        sf::Vector2u size = image.getSize();
+        mask.width = source.frameWidth;
+        mask.height = int(size.y);
+        if (mask.width > 64 || mask.height > 64 || size.x % source.frameWidth != 0) {
+            printf("%s doesn't fit in a 64x64 mask\n", path.c_str());
+            return false;
+        }
+        if (unsigned(source.frame + 1) * source.frameWidth > size.x) {
+            printf("%s has no frame %d\n", path.c_str(), source.frame);
+            return false;
+        }
+        mask.rows.assign(mask.height, 0);
+        mask.left = mask.width, mask.top = mask.height;
+        for (int y = 0; y < mask.height; y++) {
+            for (int column = 0; column < mask.width; column++) {
+                if (image.getPixel(unsigned(source.frame * source.frameWidth + column), unsigned(y)).a < AlphaThreshold)
+                    continue;
+                mask.rows[y] |= uint64_t(1) << column;
+                mask.left = min(mask.left, column), mask.right = max(mask.right, column + 1);
+                mask.top = min(mask.top, y), mask.bottom = max(mask.bottom, y + 1);
+            }
+        }
+        if (mask.right == 0) {
+            printf("%s has no solid pixels\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void writeBox(FILE* out, int left, int top, int right, int bottom) {
+        fprintf(out, "{ %d.f, %d.f, %d.f, %d.f }", left, top, right - left, bottom - top);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        printf("usage: %s CollisionMaskData.cpp\n", argv[0]);
+        return 2;
+    }
+    const int Count = int(sizeof(Sources) / sizeof(Sources[0]));
+    Mask masks[Count];
+    for (int i = 0; i < Count; i++) {
+        if (!build(Sources[i], masks[i])) {
+            printf("Couldn't build the mask for %s\n", Sources[i].image);
+            return 1;
+        }
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (!out) {
+        printf("Couldn't write %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(out, "//Generated by Benchmarks/BuildCollisionMasks.cpp from Resources/Images, don't edit by hand\n\n");
+    fprintf(out, "#include \"CollisionMasks.h\"\n\n");
+    fprintf(out, "namespace CollisionMaskData {\n");
+    for (int i = 0; i < Count; i++) {
+        const Mask& mask = masks[i];
+        fprintf(out, "    //%s.png, frame %d\n", Sources[i].image, Sources[i].frame);
+        fprintf(out, "    const CollisionMask %s = { %d, %d, ", Sources[i].name, mask.width, mask.height);
+        writeBox(out, mask.left, mask.top, mask.right, mask.bottom);
+        fprintf(out, ", {");
+        for (int y = 0; y < mask.height; y++)
+            fprintf(out, "%s0x%016llx%s", y % 4 == 0 ? "\n        " : " ", (unsigned long long)mask.rows[y], y + 1 < mask.height ? "," : "");
+        fprintf(out, "\n    } };\n\n");
+    }
+    fprintf(out, "    const CollisionMask* const enemies[3][2] = { { &Enemy1_1, &Enemy1 }, { &Enemy2_1, &Enemy2 }, { &Enemy3_1, &Enemy3 } };\n");
+    fprintf(out, "    const Box enemyBoxes[3] = {\n");
+    for (int skin = 0; skin < 3; skin++) {
+        const Mask& a = masks[skin * 2];
+        const Mask& b = masks[skin * 2 + 1];
+        fprintf(out, "        ");
+        writeBox(out, min(a.left, b.left), min(a.top, b.top), max(a.right, b.right), max(a.bottom, b.bottom));
+        fprintf(out, skin < 2 ? ",\n" : "\n");
+    }
+    fprintf(out, "    };\n");
+    fprintf(out, "    const CollisionMask* const ships[3][3] = {\n");
+    fprintf(out, "        { &ShipStraight0, &ShipStraight1, &ShipStraight2 },\n");
+    fprintf(out, "        { &ShipLeft0, &ShipLeft1, &ShipLeft2 },\n");
+    fprintf(out, "        { &ShipRight0, &ShipRight1, &ShipRight2 }\n");
+    fprintf(out, "    };\n");
+    fprintf(out, "    const CollisionMask* const bullets[2] = { &PlayerBullet, &EnemyBullet };\n");
+    fprintf(out, "}\n");
+    fclose(out);
+    printf("Wrote %d masks to %s\n", Count, argv[1]);
+    return 0;
+}
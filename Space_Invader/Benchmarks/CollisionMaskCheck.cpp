@@ -0,0 +1,72 @@
+//Checks masksOverlap() on a few placements where the boxes already overlap, so every answer
+//comes from the masks: shapes that only share the empty corners of their boxes must miss, and
+//shapes pushed into each other from any side must hit. Runs once on a hand made mask, where
+//the answer is easy to see, and once on the real ship and enemy bullet. Exits 1 on a wrong answer.
+//
+//ctest in the CMake build folder runs it. Or build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -I. Benchmarks/CollisionMaskCheck.cpp CollisionMasks.cpp CollisionMaskData.cpp -o CollisionMaskCheck
+
+#include <cstdio>
+
+#include "CollisionMasks.h"
+#include "EntityStore.h"
+
+namespace {
+    //8x8 with the corners cut off:
+    //  ..####..
+    //  .######.
+    //  ########  (x4)
+    //  .######.
+    //  ..####..
+    CollisionMask circle() {
+        CollisionMask mask = { 8, 8, { 0.f, 0.f, 8.f, 8.f }, {} };
+        const uint64_t rows[8] = { 0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C };
+        for (int y = 0; y < 8; y++)
+            mask.rows[y] = rows[y];
+        return mask;
+    }
+
+    Box opaqueAt(const CollisionMask& mask, Vec2 position) {
+        return { position.x + mask.opaque.left, position.y + mask.opaque.top, mask.opaque.width, mask.opaque.height };
+    }
+
+    int failures = 0;
+
+    void check(const char* name, const CollisionMask& a, Vec2 aPosition, const CollisionMask& b, Vec2 bPosition, bool expected) {
+        bool boxes = opaqueAt(a, aPosition).intersects(opaqueAt(b, bPosition));
+        bool hit = masksOverlap(a, aPosition, b, bPosition);
+        //Swapped round the shift goes the other way, the answer can't change
+        bool swapped = masksOverlap(b, bPosition, a, aPosition);
+        bool ok = boxes && hit == expected && swapped == expected;
+        if (!ok)
+            failures++;
+        printf("%-44s %s%s\n", name, hit ? "hit " : "miss", ok ? "" : boxes ? " (WRONG)" : " (WRONG, the boxes don't even overlap)");
+    }
+}
+
+int main() {
+    const CollisionMask disc = circle();
+    const Vec2 at = { 100.f, 200.f };
+    check("circle, only the corners overlap (down right)", disc, at, disc, { 106.f, 206.f }, false);
+    check("circle, only the corners overlap (down left)", disc, at, disc, { 94.f, 206.f }, false);
+    check("circle, only the corners overlap (up right)", disc, at, disc, { 106.f, 194.f }, false);
+    check("circle, one pixel further in (down right)", disc, at, disc, { 105.f, 205.f }, true);
+    check("circle, one pixel further in (up left)", disc, at, disc, { 95.f, 195.f }, true);
+    check("circle, rounded to the corner", disc, at, disc, { 105.6f, 205.6f }, false);
+    check("circle, rounded one pixel in", disc, at, disc, { 105.4f, 205.4f }, true);
+    check("circle, one row into the top", disc, at, disc, { 103.f, 192.6f }, true);
+
+    //The ship's wings start a few pixels down, a bullet beside its top corners passes
+    const CollisionMask& ship = shipMask(0, 0);
+    const CollisionMask& bullet = bulletMask(BulletSkin::EnemyBullet);
+    const Vec2 shipAt = { 300.f, 500.f };
+    check("ship, bullet past the top left corner", ship, shipAt, bullet, { 299.f, 500.f }, false);
+    check("ship, bullet past the top right corner", ship, shipAt, bullet, { 344.f, 500.f }, false);
+    check("ship, bullet rounded past the corner", ship, shipAt, bullet, { 299.4f, 500.f }, false);
+    check("ship, bullet rounded onto the wing", ship, shipAt, bullet, { 299.6f, 500.f }, true);
+    check("ship, bullet on the nose", ship, shipAt, bullet, { 316.f, 492.f }, true);
+
+    if (failures)
+        printf("%d wrong\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+//Runs the simulation headless for a fixed number of ticks per scenario and reports how long
+//each phase of GameSimulation::step() takes per tick. Scenarios cover the four level layouts,
+//endless mode played by the autopilot, and synthetic stress tests with thousands of bullets
+//or hundreds of enemies on screen.
+//
+//    GameLoopBench [--ticks N] [--json file] [--only name]
+//
+//The JSON has one entry per scenario, so runs from different commits can be diffed.
+//Build with the CMake project in the repository root, or from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/GameLoopBench.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp Autopilot.cpp -o GameLoopBench
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Autopilot.h"
+#include "GameSimulation.h"
+#include "Kernels.h"
+
+using namespace std;
+
+struct Scenario {
+    const char* name;
+    int level;
+    uint32_t bullets; //Kept on screen every tick, 0 for a normal game driven by the autopilot
+    int ticks;
+    uint32_t enemies; //Endless stress only, kept alive every tick on top of what the waves spawn
+};
+
+struct Result {
+    const Scenario* scenario;
+    PhaseTimings timings;
+    uint64_t pairTests;
+    uint64_t bulletTicks; //Live bullets summed over every tick
+    bool endedEarly;
+};
+
+namespace {
+    const Scenario Scenarios[] = {
+        { "level1", 1, 0, 6000, 0 },
+        { "level2", 2, 0, 6000, 0 },
+        { "level3", 3, 0, 6000, 0 },
+        { "level4", 4, 0, 6000, 0 },
+        { "infinite", InfiniteLevel, 0, 24000, 0 },
+        { "stress_10k", 1, 10000, 1000, 0 },
+        { "stress_50k", 1, 50000, 200, 0 },
+        { "endless_256", InfiniteLevel, 0, 6000, MaxEndlessEnemies },
+    };
+
+    //Spawns bullets until there are count of them, half going up from the bottom, half coming down
+    void topUpBullets(GameSimulation& sim, uint32_t count, mt19937& randomizer) {
+        uniform_real_distribution<float> column(0.f, PlayfieldWidth - 40.f), row(0.f, PlayfieldHeight - 20.f);
+        while (sim.bullets.slots.live < count) {
+            bool fromPlayer = sim.bullets.slots.live % 2 == 0;
+            Vec2 velocity = { 0.f, fromPlayer ? -PlayerBulletSpeed : 240.f };
+            sim.spawnBullet({ column(randomizer), row(randomizer) }, velocity,
+                fromPlayer ? BulletSkin::PlayerBullet : BulletSkin::EnemyBullet, fromPlayer);
+        }
+    }
+
+    //Fills the formation area with enemies until there are count of them, lined up on the 5px steps
+    //the formation kernel expects
+    void topUpEnemies(GameSimulation& sim, uint32_t count, mt19937& randomizer) {
+        uniform_int_distribution<int> step(0, 120), row(0, 7), fire(1, 3);
+        while (sim.enemies.size() < count) {
+            int type = fire(randomizer);
+            int r = row(randomizer);
+            sim.spawnEnemy({ 40.f + step(randomizer) * 5.f, 100.f + r * 50.f }, r % 2 == 0 ? 1 : -1, type, 1, Tint::Green, 1 << 30, EnemyBulletSpeeds[type], EnemyFireRates[type]);
+        }
+    }
+
+    Result run(const Scenario& scenario, int ticks) {
+        GameSimulation sim(1);
+        sim.start(scenario.level, 0.f);
+        //Get through the spawn and the level banner before measuring anything
+        while (sim.level_set || sim.inIntro())
+            sim.step(InputFrame());
+        sim.lives = 1 << 30;
+
+        mt19937 randomizer(99);
+        InputFrame fire;
+        fire.fire = true;
+        if (scenario.bullets) {
+            //Nothing dies and nothing gets hit, so the load stays the same for the whole run
+            for (uint32_t i = 0; i < sim.enemies.slots.slots(); i++)
+                sim.enemies.health[i] = 1 << 30;
+            sim.bullets.reserve(scenario.bullets + 1024);
+        }
+
+        Result result = { &scenario, PhaseTimings(), 0, 0, false };
+        sim.timings = &result.timings;
+        uint64_t pairTestsBefore = sim.stats.totalPairTests;
+        for (int tick = 0; tick < ticks; tick++) {
+            if (!sim.playing()) {
+                result.endedEarly = true;
+                break;
+            }
+            if (scenario.bullets) {
+                sim.player.invulnerability = 1.f;
+                topUpBullets(sim, scenario.bullets, randomizer);
+            }
+            if (scenario.enemies) {
+                //Keep them from walking off the bottom and ending the run
+                for (uint32_t i = 0; i < sim.enemies.slots.slots(); i++) {
+                    if (sim.enemies.y[i] >= 450.f)
+                        sim.enemies.slots.kill(i);
+                }
+                sim.enemies.slots.collectDead();
+                topUpEnemies(sim, scenario.enemies, randomizer);
+            }
+            result.bulletTicks += sim.bullets.slots.live;
+            sim.step(scenario.bullets ? fire : autopilot(sim));
+        }
+        result.pairTests = sim.stats.totalPairTests - pairTestsBefore;
+        return result;
+    }
+
+    double perTick(uint64_t total, const Result& result) {
+        return result.timings.ticks ? double(total) / result.timings.ticks : 0.0;
+    }
+
+    void writeJson(FILE* out, const vector<Result>& results) {
+        fprintf(out, "{\n  \"benchmark\": \"game_loop\",\n  \"kernels\": \"%s\",\n  \"tick_rate\": %g,\n  \"scenarios\": [\n",
+            activeKernels().name, double(TickRate));
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            const PhaseTimings& t = r.timings;
+            fprintf(out, "    {\n      \"name\": \"%s\",\n      \"ticks\": %llu,\n      \"ended_early\": %s,\n", r.scenario->name,
+                (unsigned long long)t.ticks, r.endedEarly ? "true" : "false");
+            fprintf(out, "      \"ns_per_tick\": { \"spawn\": %.1f, \"movement\": %.1f, \"firing\": %.1f, \"collision\": %.1f, \"cleanup\": %.1f, \"total\": %.1f },\n",
+                perTick(t.spawn, r), perTick(t.movement, r), perTick(t.firing, r), perTick(t.collision, r), perTick(t.cleanup, r), perTick(t.total(), r));
+            fprintf(out, "      \"pair_tests_per_tick\": %.1f,\n      \"bullets_per_tick\": %.1f\n    }%s\n",
+                perTick(r.pairTests, r), perTick(r.bulletTicks, r), i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 0;
+    string jsonPath, only;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc)
+            ticks = atoi(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (arg == "--only" && i + 1 < argc)
+            only = argv[++i];
+        else {
+            printf("usage: %s [--ticks N] [--json file] [--only name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("kernels: %s\n\n", activeKernels().name);
+    printf("%-13s %7s %10s %10s %10s %10s %10s %10s %9s\n", "scenario", "ticks", "spawn", "movement", "firing", "collision", "cleanup", "total", "bullets");
+    vector<Result> results;
+    for (const Scenario& scenario : Scenarios) {
+        if (!only.empty() && only != scenario.name)
+            continue;
+        Result r = run(scenario, ticks > 0 ? ticks : scenario.ticks);
+        const PhaseTimings& t = r.timings;
+        printf("%-13s %7llu %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f %9.0f%s\n", scenario.name, (unsigned long long)t.ticks,
+            perTick(t.spawn, r), perTick(t.movement, r), perTick(t.firing, r), perTick(t.collision, r), perTick(t.cleanup, r),
+            perTick(t.total(), r), perTick(r.bulletTicks, r), r.endedEarly ? "  (ended early)" : "");
+        results.push_back(r);
+    }
+    printf("\nns per tick\n");
+
+    if (!jsonPath.empty()) {
+        FILE* out = fopen(jsonPath.c_str(), "w");
+        if (!out) {
+            printf("Couldn't write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        writeJson(out, results);
+        fclose(out);
+    }
+    return 0;
+}
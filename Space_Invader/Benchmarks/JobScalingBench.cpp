@@ -0,0 +1,137 @@
+//Runs the same heavy scene with the collision and bullet phases split over 1, 2, 4... threads
+//and reports how the time per tick scales. Every run has to end on the same checksum as the
+//run without a job system, otherwise the parallel path changed the game and it says so.
+//
+//    JobScalingBench [--ticks N] [--bullets N] [--threads N]
+//
+//Build with the CMake project in the repository root, or from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/JobScalingBench.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp -o JobScalingBench
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameSimulation.h"
+#include "JobSystem.h"
+#include "Kernels.h"
+
+using namespace std;
+
+namespace {
+    const uint32_t SceneEnemies = 200;
+
+    struct Result {
+        unsigned threads; //0 is the plain serial path
+        PhaseTimings timings;
+        uint64_t checksum;
+        int score;
+        bool endedEarly;
+    };
+
+    //Bullets everywhere, half of them the player's going up, plus a crowd of enemies kept topped
+    //up so they keep getting shot. Seeded the same every run so only the thread count differs.
+    Result run(JobSystem* jobs, int ticks, uint32_t bulletCount) {
+        //Endless mode so clearing the enemies never ends the level
+        GameSimulation sim(3);
+        sim.start(InfiniteLevel, 0.f);
+        while (sim.level_set || sim.inIntro())
+            sim.step(InputFrame());
+        sim.lives = 1 << 30;
+        sim.bullets.reserve(bulletCount + 1024);
+        sim.jobs = jobs;
+
+        mt19937 randomizer(42);
+        uniform_real_distribution<float> column(0.f, PlayfieldWidth - 40.f), row(0.f, PlayfieldHeight - 20.f);
+        uniform_int_distribution<int> step(0, 120), enemyRow(0, 6), fire(1, 3);
+
+        Result result = { jobs ? jobs->threadCount() : 0, PhaseTimings(), 0, 0, false };
+        PhaseTimings warmup;
+        for (int tick = 0; tick < ticks + 10 && sim.playing(); tick++) {
+            //The first few ticks grow the buffers, they're left out of the timings
+            sim.timings = tick < 10 ? &warmup : &result.timings;
+            for (uint32_t i = 0; i < sim.enemies.slots.slots(); i++) {
+                if (sim.enemies.slots.alive[i] && sim.enemies.y[i] >= 450.f)
+                    sim.enemies.slots.kill(i);
+            }
+            sim.enemies.slots.collectDead();
+            while (sim.enemies.size() < SceneEnemies) {
+                int type = fire(randomizer);
+                int r = enemyRow(randomizer);
+                sim.spawnEnemy({ 40.f + step(randomizer) * 5.f, 100.f + r * 50.f }, r % 2 == 0 ? 1 : -1, type, 1, Tint::Green, 3, EnemyBulletSpeeds[type], EnemyFireRates[type]);
+            }
+            while (sim.bullets.slots.live < bulletCount) {
+                bool fromPlayer = sim.bullets.slots.live % 2 == 0;
+                Vec2 velocity = { 0.f, fromPlayer ? -PlayerBulletSpeed : 240.f };
+                sim.spawnBullet({ column(randomizer), row(randomizer) }, velocity,
+                    fromPlayer ? BulletSkin::PlayerBullet : BulletSkin::EnemyBullet, fromPlayer);
+            }
+            InputFrame input;
+            input.fire = true;
+            input.left = (tick / 240) % 2 == 0;
+            input.right = !input.left;
+            sim.step(input);
+        }
+        result.endedEarly = !sim.playing();
+        result.checksum = sim.checksum();
+        result.score = sim.global_score;
+        return result;
+    }
+
+    double perTick(uint64_t total, const PhaseTimings& timings) {
+        return timings.ticks ? double(total) / timings.ticks : 0.0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 1000;
+    uint32_t bulletCount = 50000;
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc)
+            ticks = atoi(argv[++i]);
+        else if (arg == "--bullets" && i + 1 < argc)
+            bulletCount = uint32_t(atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc)
+            maxThreads = unsigned(max(1, atoi(argv[++i])));
+        else {
+            printf("usage: %s [--ticks N] [--bullets N] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("kernels: %s, %u bullets, %u enemies, %d ticks\n\n", activeKernels().name, bulletCount, SceneEnemies, ticks);
+    printf("%-8s %10s %10s %10s %8s %8s  %s\n", "threads", "movement", "collision", "total", "speedup", "score", "checksum");
+
+    Result serial = run(nullptr, ticks, bulletCount);
+    double serialTotal = perTick(serial.timings.total(), serial.timings);
+    auto print = [&](const Result& r) {
+        double total = perTick(r.timings.total(), r.timings);
+        printf("%-8s %10.0f %10.0f %10.0f %7.2fx %8d  %016llx%s%s\n", r.threads ? to_string(r.threads).c_str() : "serial",
+            perTick(r.timings.movement, r.timings), perTick(r.timings.collision, r.timings), total,
+            total > 0.0 ? serialTotal / total : 0.0, r.score, (unsigned long long)r.checksum,
+            r.checksum == serial.checksum ? "" : "  MISMATCH", r.endedEarly ? "  (ended early)" : "");
+    };
+    print(serial);
+
+    bool matched = true;
+    vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+    for (unsigned threads : counts) {
+        JobSystem jobs(threads);
+        Result r = run(&jobs, ticks, bulletCount);
+        print(r);
+        matched = matched && r.checksum == serial.checksum;
+    }
+    printf("\nns per tick\n");
+    if (!matched) {
+        printf("The parallel path doesn't match the serial one\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+//Micro-benchmark for the movement kernels in Kernels.cpp.
+//Times every kernel set this CPU supports at 1k, 10k and 100k projectiles, checks they
+//all produce identical results, and prints the speedup over the scalar version.
+//
+//Build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -I. Benchmarks/KernelBench.cpp Kernels.cpp -o KernelBench
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Geometry.h"
+#include "Kernels.h"
+
+using namespace std;
+
+struct BulletData {
+    vector<float> x, y, vx, vy, previousX, previousY;
+    vector<uint64_t> offscreen;
+
+    explicit BulletData(uint32_t count) {
+        mt19937 randomizer(1234);
+        uniform_real_distribution<float> position(-20.f, PlayfieldHeight + 20.f), speed(-480.f, 480.f);
+        for (uint32_t i = 0; i < count; i++) {
+            x.push_back(position(randomizer));
+            y.push_back(position(randomizer));
+            vx.push_back(speed(randomizer) / 16.f);
+            vy.push_back(speed(randomizer));
+        }
+        previousX.resize(count);
+        previousY.resize(count);
+        offscreen.resize(maskWords(count));
+    }
+
+    BulletArrays arrays() {
+        return { x.data(), y.data(), vx.data(), vy.data(), previousX.data(), previousY.data(), uint32_t(x.size()) };
+    }
+};
+
+//A formation scattered across every phase of the walk, so all the branches get taken
+struct FormationData {
+    vector<float> x, y;
+    vector<int32_t> direction, movever, flip;
+    vector<uint64_t> edgeHit, reachedBottom;
+
+    explicit FormationData(uint32_t count) {
+        mt19937 randomizer(4321);
+        uniform_int_distribution<int> column(8, 128), row(20, 110), coin(0, 1);
+        for (uint32_t i = 0; i < count; i++) {
+            x.push_back(column(randomizer) * 5.f);
+            y.push_back(row(randomizer) * 5.f);
+            direction.push_back(coin(randomizer) ? 1 : -1);
+            movever.push_back(coin(randomizer));
+            flip.push_back(coin(randomizer));
+        }
+        edgeHit.resize(maskWords(count));
+        reachedBottom.resize(maskWords(count));
+    }
+
+    FormationArrays arrays() {
+        return { x.data(), y.data(), direction.data(), movever.data(), flip.data(), uint32_t(x.size()) };
+    }
+};
+
+template <typename Function>
+double nanosecondsPerCall(int calls, Function&& function) {
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++)
+        function();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - begin).count() / calls;
+}
+
+int main() {
+    vector<const KernelSet*> sets = { &scalarKernels(), sse2Kernels(), avx2Kernels() };
+    const uint32_t sizes[] = { 1000, 10000, 100000 };
+    bool identical = true;
+
+    printf("active kernels: %s\n\n", activeKernels().name);
+    printf("%-10s %-8s %14s %14s %10s\n", "kernel", "count", "bullets ns", "formation ns", "speedup");
+
+    for (uint32_t count : sizes) {
+        int calls = int(20000000 / count) + 10;
+        double scalarTime = 0.0;
+        BulletData referenceBullets(count);
+        FormationData referenceFormation(count);
+        scalarKernels().integrateBullets(referenceBullets.arrays(), 1.f / 120.f, PlayfieldHeight, referenceBullets.offscreen.data());
+        scalarKernels().stepFormation(referenceFormation.arrays(), referenceFormation.edgeHit.data(), referenceFormation.reachedBottom.data());
+
+        for (const KernelSet* set : sets) {
+            if (!set)
+                continue;
+
+            //One step from the same start must match the scalar reference exactly
+            BulletData bullets(count);
+            FormationData formation(count);
+            set->integrateBullets(bullets.arrays(), 1.f / 120.f, PlayfieldHeight, bullets.offscreen.data());
+            set->stepFormation(formation.arrays(), formation.edgeHit.data(), formation.reachedBottom.data());
+            if (bullets.x != referenceBullets.x || bullets.y != referenceBullets.y || bullets.offscreen != referenceBullets.offscreen
+                || formation.x != referenceFormation.x || formation.y != referenceFormation.y || formation.direction != referenceFormation.direction
+                || formation.movever != referenceFormation.movever || formation.edgeHit != referenceFormation.edgeHit
+                || formation.reachedBottom != referenceFormation.reachedBottom) {
+                printf("%s does not match the scalar kernels at %u entities\n", set->name, count);
+                identical = false;
+            }
+
+            //Tiny timestep so the bullets stay put and every call sees the same data
+            BulletArrays bulletArrays = bullets.arrays();
+            double bulletTime = nanosecondsPerCall(calls, [&]() {
+                set->integrateBullets(bulletArrays, 1e-9f, PlayfieldHeight, bullets.offscreen.data());
+            });
+            FormationArrays formationArrays = formation.arrays();
+            double formationTime = nanosecondsPerCall(calls, [&]() {
+                set->stepFormation(formationArrays, formation.edgeHit.data(), formation.reachedBottom.data());
+            });
+
+            if (set == &scalarKernels())
+                scalarTime = bulletTime + formationTime;
+            printf("%-10s %-8u %14.0f %14.0f %9.2fx\n", set->name, count, bulletTime, formationTime, scalarTime / (bulletTime + formationTime));
+        }
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+//Plays a co-op game between two NetSessions in one process, over a fake link with latency,
+//jitter and packet loss, and checks both sides end up in the same state as an offline run of the
+//same inputs. Both ships are flown by the autopilot, each looking at its own (predicted) game,
+//so guesses go wrong about as often as they would with people.
+//
+//    NetplayLoopback [--ticks N] [--latency MS] [--jitter MS] [--loss PERCENT]
+//                    [--delay N] [--rollback N] [--seed N] [--level N]
+//
+//Exits 1 when the sides or the reference run disagree, or when the client doesn't end its run
+//after the host leaves. Also times restore + re-simulate on a
+//busy state, which is what a rollback costs.
+//
+//Build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/NetplayLoopback.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp Netplay.cpp Replay.cpp Autopilot.cpp -o NetplayLoopback
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Autopilot.h"
+#include "GameSimulation.h"
+#include "Netplay.h"
+#include "Replay.h"
+
+using namespace std;
+
+namespace {
+    struct LinkSettings {
+        double latency = 40; //ms one way
+        double jitter = 15; //ms, each packet gets up to this much extra
+        double loss = 5; //percent
+    };
+
+    //Packets one way, delivered once the shared clock passes their arrival time. Jitter lets a
+    //later packet overtake an earlier one, like on a real network.
+    class Link {
+    public:
+        Link(const LinkSettings& settings, uint64_t seed) : settings(settings), randomizer(seed) {}
+
+        void send(const vector<uint8_t>& packet, double now) {
+            sent++;
+            if (uniform_real_distribution<double>(0, 100)(randomizer) < settings.loss) {
+                lost++;
+                return;
+            }
+            double arrival = now + settings.latency + uniform_real_distribution<double>(0, settings.jitter)(randomizer);
+            auto at = upper_bound(queue.begin(), queue.end(), arrival, [](double time, const InFlight& p) { return time < p.arrival; });
+            queue.insert(at, { arrival, packet });
+        }
+
+        bool receive(vector<uint8_t>& packet, double now) {
+            if (queue.empty() || queue.front().arrival > now)
+                return false;
+            packet = move(queue.front().bytes);
+            queue.pop_front();
+            return true;
+        }
+
+        LinkSettings settings;
+        uint64_t sent = 0, lost = 0;
+
+    private:
+        struct InFlight {
+            double arrival;
+            vector<uint8_t> bytes;
+        };
+        mt19937_64 randomizer;
+        deque<InFlight> queue;
+    };
+
+    class LoopbackTransport : public Transport {
+    public:
+        LoopbackTransport(Link& out, Link& in, const double& clock) : out(out), in(in), clock(clock) {}
+        void send(const vector<uint8_t>& packet) override { out.send(packet, clock); }
+        bool receive(vector<uint8_t>& packet) override { return in.receive(packet, clock); }
+
+    private:
+        Link& out;
+        Link& in;
+        const double& clock;
+    };
+
+    //Keeps the run going for the whole tick count, both sides have to do the same
+    void setUp(GameSimulation& sim, int level) {
+        sim.coop = true;
+        sim.setLevels(defaultLevels());
+        sim.start(level, GameStartIntroTime);
+        sim.lives = 1000000;
+    }
+
+    struct Peer {
+        GameSimulation sim;
+        LoopbackTransport transport;
+        NetSession session;
+        vector<InputFrame> sent; //sent[tick] = the input this side flew with on that tick
+        double longestAdvance = 0; //seconds
+
+        Peer(Link& out, Link& in, const double& clock, int player, NetSettings settings)
+            : sim(0), transport(out, in, clock), session(transport, player, settings) {}
+
+        const PlayerShip& ship() const { return session.player() == 0 ? sim.player : sim.partner; }
+
+        //Inputs go in at frame() + inputDelay, ticks before inputDelay are blank
+        void advance() {
+            InputFrame input = autopilot(sim, ship());
+            auto begin = chrono::steady_clock::now();
+            bool stepped = session.advance(input);
+            longestAdvance = max(longestAdvance, chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+            if (stepped)
+                sent.push_back(input);
+        }
+
+        InputFrame input(uint64_t tick) const {
+            uint64_t delay = uint64_t(session.settings().inputDelay);
+            return tick >= delay && tick - delay < sent.size() ? sent[tick - delay] : InputFrame();
+        }
+    };
+
+    void report(const char* name, const Peer& peer) {
+        const NetStats& stats = peer.session.stats();
+        printf("%s: %llu ticks, %llu stalls, %llu rollbacks (%llu ticks re-simulated, longest %llu), "
+            "slowest tick %.2f ms, %llu packets out, %llu in\n", name,
+            (unsigned long long)stats.ticks, (unsigned long long)stats.stalls, (unsigned long long)stats.rollbacks,
+            (unsigned long long)stats.resimulatedTicks, (unsigned long long)stats.longestRollback,
+            peer.longestAdvance * 1000, (unsigned long long)stats.packetsSent, (unsigned long long)stats.packetsReceived);
+    }
+
+    //Restores the state from rollbackWindow ticks ago and plays them again, over and over, the way
+    //a worst case rollback does
+    void timeResimulation(const GameSimulation& busy, const Peer& host, const Peer& client, int window) {
+        GameSimulation sim(0), saved(0);
+        busy.copyStateTo(saved);
+        uint64_t first = busy.tick;
+        uint64_t ticks = 0;
+        auto begin = chrono::steady_clock::now();
+        double seconds = 0;
+        while (seconds < 1.0) {
+            saved.copyStateTo(sim);
+            for (int i = 0; i < window; i++)
+                sim.step(host.input(first + i), client.input(first + i));
+            ticks += window;
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        }
+        double perRollback = seconds / (ticks / window);
+        printf("re-simulation: %.0f ticks/s with %u enemies and %u bullets, a %d tick rollback takes %.3f ms (%.1f%% of a tick)\n",
+            ticks / seconds, busy.enemies.slots.live, busy.bullets.slots.live, window, perRollback * 1000,
+            perRollback / TickDuration * 100);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LinkSettings link;
+    NetSettings settings;
+    uint64_t ticks = uint64_t(TickRate) * 60;
+    uint64_t seed = 1;
+    int level = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i];
+        double value = atof(argv[i + 1]);
+        if (option == "--ticks") ticks = uint64_t(value);
+        else if (option == "--latency") link.latency = value;
+        else if (option == "--jitter") link.jitter = value;
+        else if (option == "--loss") link.loss = value;
+        else if (option == "--delay") settings.inputDelay = int(value);
+        else if (option == "--rollback") settings.rollbackWindow = int(value);
+        else if (option == "--seed") seed = uint64_t(value);
+        else if (option == "--level") level = int(value);
+        else {
+            printf("unknown option %s\n", option.c_str());
+            return 2;
+        }
+    }
+
+    double clock = 0; //ms, both sides tick on it in lockstep
+    const double tickLength = TickDuration * 1000;
+    Link toClient(link, seed * 2 + 1), toHost(link, seed * 2 + 2);
+    Peer host(toClient, toHost, clock, 0, settings);
+    Peer client(toHost, toClient, clock, 1, settings);
+
+    uint64_t sessionSeed = seed;
+    int sessionLevel = level, joinedLevel = 0;
+    uint64_t joinedSeed = 0;
+    bool hostReady = false, clientReady = false;
+    while (!hostReady || !clientReady) {
+        if (!clientReady)
+            clientReady = client.session.handshake(joinedSeed, joinedLevel);
+        if (!hostReady)
+            hostReady = host.session.handshake(sessionSeed, sessionLevel);
+        clock += tickLength;
+    }
+    printf("handshake took %.0f ms, link %.0f ms +%.0f ms jitter, %.1f%% loss, input delay %d, rollback window %d\n",
+        clock, link.latency, link.jitter, link.loss, host.session.settings().inputDelay, host.session.settings().rollbackWindow);
+
+    host.sim = GameSimulation(sessionSeed);
+    setUp(host.sim, sessionLevel);
+    host.session.begin(host.sim);
+    client.sim = GameSimulation(joinedSeed);
+    setUp(client.sim, joinedLevel);
+    client.session.begin(client.sim);
+
+    while (host.session.frame() < ticks || client.session.frame() < ticks) {
+        for (Peer* peer : { &host, &client }) {
+            if (peer->session.frame() < ticks)
+                peer->advance();
+            else
+                peer->session.poll();
+        }
+        clock += tickLength;
+    }
+    //Stop dropping packets and let the last inputs arrive, the final guesses get corrected on the way
+    toClient.settings.loss = toHost.settings.loss = 0;
+    for (int i = 0; i < 2 * TickRate; i++) {
+        host.session.poll();
+        client.session.poll();
+        clock += tickLength;
+    }
+
+    GameSimulation reference(sessionSeed);
+    setUp(reference, sessionLevel);
+    for (uint64_t tick = 0; tick < ticks; tick++)
+        reference.step(host.input(tick), client.input(tick));
+
+    report("host", host);
+    report("client", client);
+    printf("link: %llu of %llu packets lost\n", (unsigned long long)(toClient.lost + toHost.lost),
+        (unsigned long long)(toClient.sent + toHost.sent));
+
+    uint64_t hostChecksum = host.sim.checksum(), clientChecksum = client.sim.checksum(), referenceChecksum = reference.checksum();
+    bool synced = hostChecksum == clientChecksum && hostChecksum == referenceChecksum && !host.session.desynced() && !client.session.desynced();
+    printf("after %llu ticks: level %d, score %d, checksums host %016llx client %016llx offline %016llx %s\n",
+        (unsigned long long)ticks, host.sim.level, host.sim.global_score, (unsigned long long)hostChecksum,
+        (unsigned long long)clientChecksum, (unsigned long long)referenceChecksum, synced ? "(match)" : "(DESYNC)");
+    if (host.session.desynced() || client.session.desynced())
+        printf("desync detected in play at tick %llu\n", (unsigned long long)min(host.session.firstDesync(), client.session.firstDesync()));
+
+    //The state rollbackWindow ticks before the end, with the most going on
+    int window = host.session.settings().rollbackWindow;
+    if (ticks > uint64_t(window)) {
+        GameSimulation busy(sessionSeed);
+        setUp(busy, sessionLevel);
+        for (uint64_t tick = 0; tick < ticks - window; tick++)
+            busy.step(host.input(tick), client.input(tick));
+        timeResimulation(busy, host, client, window);
+    }
+
+    //The host quits, the client has to end its run instead of waiting on input forever
+    host.session.leave();
+    for (int i = 0; i < TickRate && !client.session.partnerLeft(); i++) {
+        clock += tickLength;
+        client.session.poll();
+    }
+    bool ended = client.session.partnerLeft() && client.sim.game_over;
+    printf("host left: client %s\n", ended ? "ended its run" : "DIDN'T NOTICE");
+    return synced && ended ? 0 : 1;
+}
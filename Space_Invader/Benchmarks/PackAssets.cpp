@@ -0,0 +1,85 @@
+//Packs the files listed in a manifest into one asset archive for the game to map at startup.
+//Paths are relative to the working directory, the same as the game's, so run it from Space_Invader/:
+//
+//    PackAssets Resources/assets.txt Resources.pak
+//
+//Fails (exit 1) when a file that isn't marked optional is missing, so a broken archive never ships.
+//
+//Build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -I. Benchmarks/PackAssets.cpp AssetArchive.cpp -o PackAssets
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+
+using namespace std;
+
+namespace {
+    //Shells out to oggenc, there's no encoder in the game itself. Falls back to the original
+    //bytes with a warning so a machine without it can still build a working (bigger) archive.
+    void encodeOgg(const string& path, const string& scratch, vector<uint8_t>& bytes) {
+        string command = "oggenc -Q -q 4 -o \"" + scratch + "\" \"" + path + "\"";
+        vector<uint8_t> encoded;
+        if (system(command.c_str()) == 0 && readAssetFile(scratch, encoded) && !encoded.empty()) {
+            printf("  %s: %zu -> %zu bytes as Ogg Vorbis\n", path.c_str(), bytes.size(), encoded.size());
+            bytes.swap(encoded);
+        }
+        else
+            printf("  %s: oggenc failed or isn't installed, stored as it is\n", path.c_str());
+        remove(scratch.c_str());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        printf("usage: %s manifest.txt output.pak\n", argv[0]);
+        return 2;
+    }
+    string manifestPath = argv[1], outputPath = argv[2];
+
+    vector<ManifestEntry> manifest;
+    string error;
+    if (!readAssetManifest(manifestPath, manifest, error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+
+    vector<PackedAsset> assets;
+    size_t total = 0;
+    bool missing = false;
+    for (const ManifestEntry& entry : manifest) {
+        PackedAsset asset;
+        asset.name = entry.path;
+        if (!readAssetFile(entry.path, asset.bytes)) {
+            printf("%s:%d: %s %s\n", manifestPath.c_str(), entry.line, entry.path.c_str(),
+                entry.optional ? "isn't there, skipped" : "is missing");
+            missing = missing || !entry.optional;
+            continue;
+        }
+        if (entry.ogg)
+            encodeOgg(entry.path, outputPath + ".ogg", asset.bytes);
+        total += asset.bytes.size();
+        assets.push_back(move(asset));
+    }
+    if (missing) {
+        printf("Not writing %s, required files are missing\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (!writeAssetArchive(outputPath, assets, error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+
+    //Read it back so a bad write shows up here and not when the game starts
+    AssetArchive archive;
+    if (!archive.open(outputPath, error) || archive.size() != assets.size()) {
+        printf("Wrote %s but it doesn't read back: %s\n", outputPath.c_str(), error.c_str());
+        return 1;
+    }
+    printf("Packed %zu assets (%zu bytes) into %s\n", assets.size(), total, outputPath.c_str());
+    return 0;
+}
@@ -0,0 +1,76 @@
+//Plays a replay headless as fast as the CPU allows and checks it ends in the same state it
+//was recorded in. Also records replays with the autopilot, so there's always a full run to use.
+//
+//    ReplayFastForward run.replay                  replay it, report ticks/s, exit 1 on desync
+//    ReplayFastForward --record run.replay [seed]  let the autopilot play from level 1 and save it
+//
+//Build from the Space_Invader folder with:
+//    g++ -O2 -std=c++17 -pthread -I. Benchmarks/ReplayFastForward.cpp GameSimulation.cpp CollisionGrid.cpp CollisionMasks.cpp CollisionMaskData.cpp EntityStore.cpp FireSchedule.cpp Kernels.cpp JobSystem.cpp LevelSet.cpp Profiler.cpp Replay.cpp Autopilot.cpp -o ReplayFastForward
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Autopilot.h"
+#include "GameSimulation.h"
+#include "Replay.h"
+
+using namespace std;
+
+namespace {
+    //Nobody plays for more than an hour
+    const uint64_t MaxRecordedTicks = uint64_t(TickRate) * 3600;
+
+    int record(const string& path, uint64_t seed) {
+        Replay replay;
+        replay.begin(seed, 1, GameStartIntroTime);
+        GameSimulation sim(0);
+        replay.restart(sim);
+        while (sim.playing() && replay.ticks() < MaxRecordedTicks) {
+            InputFrame input = autopilot(sim);
+            replay.record(input);
+            sim.step(input);
+        }
+        replay.finish(sim);
+        if (!replay.save(path)) {
+            printf("Couldn't write %s\n", path.c_str());
+            return 1;
+        }
+        printf("Recorded %zu ticks (%s on level %d, score %d) to %s\n", replay.ticks(),
+            sim.game_win ? "won" : sim.game_over ? "lost" : "stopped", sim.level, sim.global_score, path.c_str());
+        return 0;
+    }
+
+    int play(const string& path) {
+        Replay replay;
+        if (!replay.load(path)) {
+            printf("Couldn't read %s\n", path.c_str());
+            return 1;
+        }
+        GameSimulation sim(0);
+        replay.restart(sim);
+
+        auto begin = chrono::steady_clock::now();
+        for (size_t tick = 0; tick < replay.ticks(); tick++)
+            sim.step(replay.input(tick));
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        uint64_t checksum = sim.checksum();
+        bool synced = replay.finalChecksum == 0 || checksum == replay.finalChecksum;
+        printf("%zu ticks (%.1f s of game) in %.3f s, %.0f ticks/s, %.0fx real time\n", replay.ticks(),
+            replay.ticks() / TickRate, seconds, replay.ticks() / seconds, replay.ticks() / TickRate / seconds);
+        printf("level %d, score %d, lives %d, checksum %016llx %s\n", sim.level, sim.global_score, sim.lives,
+            (unsigned long long)checksum, synced ? "(matches)" : "(DESYNC)");
+        return synced ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && string(argv[1]) == "--record")
+        return record(argv[2], argc >= 4 ? strtoull(argv[3], nullptr, 10) : 1);
+    if (argc == 2)
+        return play(argv[1]);
+    printf("usage: %s run.replay | --record run.replay [seed]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,53 @@
+#include "CollisionGrid.h"
+
+#include <algorithm>
+
+using namespace std;
+
+CollisionGrid::CollisionGrid()
+    : cellStart(Columns * Rows + 1, 0) {
+}
+
+//Anything outside the playfield is clamped into the border cells
+CollisionGrid::CellRange CollisionGrid::cellsFor(const Box& box) {
+    CellRange range;
+    range.x0 = min(max(int(box.left) / CellSize, 0), Columns - 1);
+    range.y0 = min(max(int(box.top) / CellSize, 0), Rows - 1);
+    range.x1 = min(max(int(box.left + box.width) / CellSize, 0), Columns - 1);
+    range.y1 = min(max(int(box.top + box.height) / CellSize, 0), Rows - 1);
+    return range;
+}
+
+void CollisionGrid::build(const vector<Box>& boxes, const vector<uint8_t>& alive) {
+    fill(cellStart.begin(), cellStart.end(), 0);
+    ranges.resize(boxes.size());
+
+    //Count how many entities land in each cell
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (!alive[i]) {
+            ranges[i] = { 0, 0, -1, -1 };
+            continue;
+        }
+        ranges[i] = cellsFor(boxes[i]);
+        for (int y = ranges[i].y0; y <= ranges[i].y1; y++)
+            for (int x = ranges[i].x0; x <= ranges[i].x1; x++)
+                cellStart[y * Columns + x + 1]++;
+    }
+    for (size_t cell = 1; cell < cellStart.size(); cell++)
+        cellStart[cell] += cellStart[cell - 1];
+
+    //Then drop each entity into its slots, cellStart[cell] doubles as the write cursor
+    items.resize(cellStart.back());
+    for (size_t i = 0; i < boxes.size(); i++)
+        for (int y = ranges[i].y0; y <= ranges[i].y1; y++)
+            for (int x = ranges[i].x0; x <= ranges[i].x1; x++)
+                items[cellStart[y * Columns + x]++] = uint32_t(i);
+
+    //The cursors ended up one cell ahead, shift them back
+    for (size_t cell = cellStart.size() - 1; cell > 0; cell--)
+        cellStart[cell] = cellStart[cell - 1];
+    cellStart[0] = 0;
+
+    stamps.stamp.assign(boxes.size(), 0);
+    stamps.queryId = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Geometry.h"
+
+//Uniform grid over the playfield, rebuilt every tick. Each cell lists the entities whose
+//box touches it, stored back to back (counting sort) so a rebuild is two linear passes.
+struct CollisionGrid {
+    static const int CellSize = 60;
+    static const int Columns = int(PlayfieldWidth) / CellSize;
+    static const int Rows = int(PlayfieldHeight) / CellSize;
+
+    std::vector<uint32_t> cellStart; //Columns * Rows + 1 offsets into items
+    std::vector<uint32_t> items;
+
+    CollisionGrid();
+
+    //Rebuilds the grid from a list of boxes, entity i is boxes[i] and is skipped unless alive[i]
+    void build(const std::vector<Box>& boxes, const std::vector<uint8_t>& alive);
+
+    //Calls visit(index) once for every entity sharing a cell with the box
+    template <typename Visitor>
+    void query(const Box& box, Visitor&& visit);
+
+    //Duplicate tracking for query(), the grid keeps one of its own. Threads querying at the
+    //same time each bring their own and go through the const overload.
+    struct QueryStamps {
+        std::vector<uint32_t> stamp; //Last query that returned each entity
+        uint32_t queryId = 0;
+    };
+    template <typename Visitor>
+    void query(const Box& box, Visitor&& visit, QueryStamps& stamps) const;
+
+private:
+    struct CellRange {
+        int x0, y0, x1, y1;
+    };
+    static CellRange cellsFor(const Box& box);
+    std::vector<CellRange> ranges; //Scratch, kept to avoid reallocating every build
+    QueryStamps stamps;
+};
+
+template <typename Visitor>
+void CollisionGrid::query(const Box& box, Visitor&& visit) {
+    query(box, visit, stamps);
+}
+
+template <typename Visitor>
+void CollisionGrid::query(const Box& box, Visitor&& visit, QueryStamps& scratch) const {
+    if (scratch.stamp.size() != ranges.size()) {
+        scratch.stamp.assign(ranges.size(), 0);
+        scratch.queryId = 0;
+    }
+    CellRange range = cellsFor(box);
+    uint32_t id = ++scratch.queryId;
+    for (int y = range.y0; y <= range.y1; y++) {
+        for (int x = range.x0; x <= range.x1; x++) {
+            int cell = y * Columns + x;
+            for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                uint32_t index = items[i];
+                if (scratch.stamp[index] == id)
+                    continue;
+                scratch.stamp[index] = id;
+                visit(index);
+            }
+        }
+    }
+}
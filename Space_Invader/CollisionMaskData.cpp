@@ -0,0 +1,253 @@
+//Generated by Benchmarks/BuildCollisionMasks.cpp from Resources/Images, don't edit by hand
+
+#include "CollisionMasks.h"
+
+namespace CollisionMaskData {
+    //Enemy1_1.png, frame 0
+    const CollisionMask Enemy1_1 = { 50, 50, { 13.f, 13.f, 24.f, 24.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x000000000fc00000, 0x000000000fc00000, 0x000000000fc00000,
+        0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000, 0x00000003ffff0000,
+        0x00000003ffff0000, 0x00000003ffff0000, 0x0000001f8fc7e000, 0x0000001f8fc7e000,
+        0x0000001f8fc7e000, 0x0000001fffffe000, 0x0000001fffffe000, 0x0000001fffffe000,
+        0x0000000070380000, 0x0000000070380000, 0x0000000070380000, 0x000000038fc70000,
+        0x000000038fc70000, 0x000000038fc70000, 0x0000001c7038e000, 0x0000001c7038e000,
+        0x0000001c7038e000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Enemy1.png, frame 0
+    const CollisionMask Enemy1 = { 50, 50, { 13.f, 12.f, 24.f, 25.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x000000000fc00000, 0x000000000fc00000, 0x000000000fc00000, 0x000000000fc00000,
+        0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000, 0x00000003ffff0000,
+        0x00000003ffff0000, 0x00000003ffff0000, 0x0000001f8fc7e000, 0x0000001f8fc7e000,
+        0x0000001f8fc7e000, 0x0000001fffffe000, 0x0000001fffffe000, 0x0000001fffffe000,
+        0x000000038fc70000, 0x000000038fc70000, 0x000000038fc70000, 0x0000001c0000e000,
+        0x0000001c0000e000, 0x0000001c0000e000, 0x0000000380070000, 0x0000000380070000,
+        0x0000000380070000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Enemy2_1.png, frame 0
+    const CollisionMask Enemy2_1 = { 50, 50, { 7.f, 13.f, 36.f, 24.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000001c0000e000, 0x0000001c0000e000, 0x0000001c0000e000,
+        0x0000070380070380, 0x0000070380070380, 0x0000070380070380, 0x0000071fffffe380,
+        0x0000071fffffe380, 0x0000071fffffe380, 0x000007fc7ff8ff80, 0x000007fc7ff8ff80,
+        0x000007fc7ff8ff80, 0x000007ffffffff80, 0x000007ffffffff80, 0x000007ffffffff80,
+        0x000000fffffffc00, 0x000000fffffffc00, 0x000000fffffffc00, 0x0000001c0000e000,
+        0x0000001c0000e000, 0x0000001c0000e000, 0x000000e000001c00, 0x000000e000001c00,
+        0x000000e000001c00, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Enemy2.png, frame 0
+    const CollisionMask Enemy2 = { 50, 50, { 6.f, 13.f, 38.f, 24.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000001c0000e000, 0x0000001c0000e000, 0x0000001c0000e000,
+        0x0000000380070000, 0x0000000380070000, 0x0000000380070000, 0x0000001fffffe000,
+        0x0000001fffffe000, 0x0000001fffffe000, 0x000001fc7ff8fe00, 0x000001fc7ff8fe00,
+        0x000001fc7ff8fe00, 0x00000fffffffffc0, 0x00000fffffffffc0, 0x00000fffffffffc0,
+        0x00000e1fffffe1c0, 0x00000e1fffffe1c0, 0x00000e1fffffe1c0, 0x00000e1c0000e1c0,
+        0x00000e1c0000e1c0, 0x00000e1c0000e1c0, 0x00000003f03f0000, 0x00000003f03f0000,
+        0x00000003f03f0000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Enemy3_1.png, frame 0
+    const CollisionMask Enemy3_1 = { 50, 50, { 6.f, 12.f, 38.f, 25.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000,
+        0x000001fffffffe00, 0x000001fffffffe00, 0x000001fffffffe00, 0x00000fffffffffc0,
+        0x00000fffffffffc0, 0x00000fffffffffc0, 0x00000ffc0fc0ffc0, 0x00000ffc0fc0ffc0,
+        0x00000ffc0fc0ffc0, 0x00000fffffffffc0, 0x00000fffffffffc0, 0x00000fffffffffc0,
+        0x00000003f03f0000, 0x00000003f03f0000, 0x00000003f03f0000, 0x0000003f8fc7e000,
+        0x0000003f8fc7e000, 0x0000003f8fc7e000, 0x00000fc000001fc0, 0x00000fc000001fc0,
+        0x00000fc000001fc0, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Enemy3.png, frame 0
+    const CollisionMask Enemy3 = { 50, 50, { 6.f, 12.f, 38.f, 25.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000, 0x000000007ff80000,
+        0x000001fffffffe00, 0x000001fffffffe00, 0x000001fffffffe00, 0x00000fffffffffc0,
+        0x00000fffffffffc0, 0x00000fffffffffc0, 0x00000ffc0fc0ffc0, 0x00000ffc0fc0ffc0,
+        0x00000ffc0fc0ffc0, 0x00000fffffffffc0, 0x00000fffffffffc0, 0x00000fffffffffc0,
+        0x0000003ff03fe000, 0x0000003ff03fe000, 0x0000003ff03fe000, 0x000001fc0fc0fe00,
+        0x000001fc0fc0fe00, 0x000001fc0fc0fe00, 0x0000003f8007e000, 0x0000003f8007e000,
+        0x0000003f8007e000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //player_animation.png, frame 0
+    const CollisionMask ShipStraight0 = { 50, 34, { 1.f, 1.f, 48.f, 32.f }, {
+        0x0000000000000000, 0x0000000003000000, 0x000000000fc00000, 0x000000000fc00000,
+        0x000000001fe00000, 0x000000009fe40000, 0x00000018fffc6000, 0x0000001bffff6000,
+        0x0000001fffffe000, 0x0000001fffffe000, 0x0000001fffffe000, 0x0000003ffffff000,
+        0x000000fffffffc00, 0x000001fffffffe00, 0x000007ffffffff80, 0x00000fffffffffc0,
+        0x00003ffffffffff0, 0x00003ffffffffff0, 0x00007ffffffffff8, 0x00007ffffffffff8,
+        0x0001fffffffffffe, 0x0001fffffffffffe, 0x0001f8ff9fe79c7e, 0x0001c0e79fe7800e,
+        0x0001c0e79fe7800e, 0x000180001fe00006, 0x000000001fe00000, 0x000000001fe00000,
+        0x000000001fe00000, 0x000000001fe00000, 0x000000001fe00000, 0x000000001fe00000,
+        0x000000000fc00000, 0x0000000000000000
+    } };
+
+    //player_animation.png, frame 1
+    const CollisionMask ShipStraight1 = { 50, 34, { 1.f, 1.f, 48.f, 28.f }, {
+        0x0000000000000000, 0x0000000003000000, 0x000000000fc00000, 0x000000000fc00000,
+        0x000000001fe00000, 0x000000009fe40000, 0x00000018fffc6000, 0x0000001bffff6000,
+        0x0000001fffffe000, 0x0000001fffffe000, 0x0000001fffffe000, 0x0000003ffffff000,
+        0x000000fffffffc00, 0x000001fffffffe00, 0x000007ffffffff80, 0x00000fffffffffc0,
+        0x00003ffffffffff0, 0x00003ffffffffff0, 0x00007ffffffffff8, 0x00007ffffffffff8,
+        0x0001fffffffffffe, 0x0001fffffffffffe, 0x0001f8ff9fe79c7e, 0x0001c0e79fe7800e,
+        0x0001c0e79fe7800e, 0x000180001fe00006, 0x000000000fc00000, 0x000000000fc00000,
+        0x0000000003000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //player_animation.png, frame 2
+    const CollisionMask ShipStraight2 = { 50, 34, { 1.f, 1.f, 48.f, 25.f }, {
+        0x0000000000000000, 0x0000000003000000, 0x000000000fc00000, 0x000000000fc00000,
+        0x000000001fe00000, 0x000000009fe40000, 0x00000018fffc6000, 0x0000001bffff6000,
+        0x0000001fffffe000, 0x0000001fffffe000, 0x0000001fffffe000, 0x0000003ffffff000,
+        0x000000fffffffc00, 0x000001fffffffe00, 0x000007ffffffff80, 0x00000fffffffffc0,
+        0x00003ffffffffff0, 0x00003ffffffffff0, 0x00007ffffffffff8, 0x00007ffffffffff8,
+        0x0001fffffffffffe, 0x0001fffffffffffe, 0x0001f8ff9fe79c7e, 0x0001c0e78fc7800e,
+        0x0001c0e78fc7800e, 0x0001800003000006, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Left.png, frame 0
+    const CollisionMask ShipLeft0 = { 42, 34, { 1.f, 1.f, 40.f, 32.f }, {
+        0x0000000000000000, 0x0000000000700000, 0x0000000001fc0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x0000000183ffd800, 0x00000001bffff800,
+        0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000007fffffe00, 0x00000007ffffff00, 0x0000000fffffffc0, 0x0000000fffffffc0,
+        0x0000003ffffffff0, 0x0000003ffffffff0, 0x000000fffffffff8, 0x000000fffffffff8,
+        0x000001fffffffffe, 0x000001fffffffffe, 0x000001f073ff3e3e, 0x000001f073ff3e3e,
+        0x000001c073ff380e, 0x0000010003ff0006, 0x0000000003ff0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x0000000003ff0000, 0x0000000003ff0000,
+        0x0000000001fc0000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Left.png, frame 1
+    const CollisionMask ShipLeft1 = { 42, 34, { 1.f, 1.f, 40.f, 29.f }, {
+        0x0000000000000000, 0x0000000000300000, 0x0000000000780000, 0x0000000000fc0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x0000000183ffd800, 0x000000019ffff800,
+        0x000000019ffff800, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000003fffffe00, 0x00000003ffffff00, 0x00000003ffffff00, 0x0000000fffffffc0,
+        0x0000000fffffffc0, 0x0000003ffffffff0, 0x000000fffffffff8, 0x000000fffffffff8,
+        0x000000fffffffff8, 0x000001fffffffffe, 0x000001fffffffffe, 0x000001f073ff3e3e,
+        0x000001c073ff380e, 0x0000010003ff0006, 0x0000000000fc0000, 0x0000000000fc0000,
+        0x0000000000fc0000, 0x0000000000780000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Left.png, frame 2
+    const CollisionMask ShipLeft2 = { 42, 34, { 1.f, 1.f, 40.f, 25.f }, {
+        0x0000000000000000, 0x0000000000780000, 0x0000000000fe0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x0000000183ffc800, 0x000000019ffff800,
+        0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000003fffffe00, 0x00000003ffffff80, 0x0000000fffffffc0, 0x0000000fffffffc0,
+        0x0000000fffffffc0, 0x0000003ffffffff0, 0x0000007ffffffffc, 0x0000007ffffffffc,
+        0x000001fffffffffe, 0x000001fffffffffe, 0x000001f073ff3e3e, 0x000001f073ff3e3e,
+        0x000001c070fe380e, 0x0000018000780002, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Right.png, frame 0
+    const CollisionMask ShipRight0 = { 42, 34, { 1.f, 1.f, 40.f, 32.f }, {
+        0x0000000000000000, 0x0000000000380000, 0x0000000000fe0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x000000006fff0600, 0x000000007ffff600,
+        0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000001ffffff80, 0x00000003ffffff80, 0x0000000fffffffc0, 0x0000000fffffffc0,
+        0x0000003ffffffff0, 0x0000003ffffffff0, 0x0000007ffffffffc, 0x0000007ffffffffc,
+        0x000001fffffffffe, 0x000001fffffffffe, 0x000001f1f3ff383e, 0x000001f1f3ff383e,
+        0x000001c073ff380e, 0x0000018003ff0002, 0x0000000003ff0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x0000000003ff0000, 0x0000000003ff0000,
+        0x0000000000fe0000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Right.png, frame 1
+    const CollisionMask ShipRight1 = { 42, 34, { 1.f, 1.f, 40.f, 29.f }, {
+        0x0000000000000000, 0x0000000000300000, 0x0000000000780000, 0x0000000000fc0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x000000006fff0600, 0x000000007fffe600,
+        0x000000007fffe600, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000001ffffff00, 0x00000003ffffff00, 0x00000003ffffff00, 0x0000000fffffffc0,
+        0x0000000fffffffc0, 0x0000003ffffffff0, 0x0000007ffffffffc, 0x0000007ffffffffc,
+        0x0000007ffffffffc, 0x000001fffffffffe, 0x000001fffffffffe, 0x000001f1f3ff383e,
+        0x000001c073ff380e, 0x0000018003ff0002, 0x0000000000fc0000, 0x0000000000fc0000,
+        0x0000000000fc0000, 0x0000000000780000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //Player_Turning_Animation_Right.png, frame 2
+    const CollisionMask ShipRight2 = { 42, 34, { 1.f, 1.f, 40.f, 25.f }, {
+        0x0000000000000000, 0x0000000000780000, 0x0000000001fc0000, 0x0000000003ff0000,
+        0x0000000003ff0000, 0x0000000003ff0000, 0x000000004fff0600, 0x000000007fffe600,
+        0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00, 0x00000001fffffe00,
+        0x00000001ffffff00, 0x00000007ffffff00, 0x0000000fffffffc0, 0x0000000fffffffc0,
+        0x0000000fffffffc0, 0x0000003ffffffff0, 0x000000fffffffff8, 0x000000fffffffff8,
+        0x000001fffffffffe, 0x000001fffffffffe, 0x000001f1f3ff383e, 0x000001f1f3ff383e,
+        0x000001c071fc380e, 0x0000010000780006, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000
+    } };
+
+    //EnemyBullet.png, frame 0
+    const CollisionMask EnemyBullet = { 16, 16, { 3.f, 0.f, 10.f, 16.f }, {
+        0x0000000000000600, 0x0000000000000700, 0x0000000000000380, 0x00000000000001c0,
+        0x00000000000000e0, 0x0000000000000070, 0x0000000000000018, 0x0000000000000ff8,
+        0x0000000000001ff0, 0x0000000000001800, 0x0000000000000e00, 0x0000000000000700,
+        0x0000000000000380, 0x00000000000001c0, 0x00000000000000e0, 0x0000000000000060
+    } };
+
+    //PlayerBullet.png, frame 0
+    const CollisionMask PlayerBullet = { 16, 16, { 5.f, 2.f, 6.f, 12.f }, {
+        0x0000000000000000, 0x0000000000000000, 0x00000000000007e0, 0x00000000000007e0,
+        0x00000000000007e0, 0x00000000000007e0, 0x00000000000007e0, 0x00000000000007e0,
+        0x00000000000007e0, 0x00000000000007e0, 0x00000000000007e0, 0x00000000000007e0,
+        0x00000000000007e0, 0x00000000000007e0, 0x0000000000000000, 0x0000000000000000
+    } };
+
+    const CollisionMask* const enemies[3][2] = { { &Enemy1_1, &Enemy1 }, { &Enemy2_1, &Enemy2 }, { &Enemy3_1, &Enemy3 } };
+    const Box enemyBoxes[3] = {
+        { 13.f, 12.f, 24.f, 25.f },
+        { 6.f, 13.f, 38.f, 24.f },
+        { 6.f, 12.f, 38.f, 25.f }
+    };
+    const CollisionMask* const ships[3][3] = {
+        { &ShipStraight0, &ShipStraight1, &ShipStraight2 },
+        { &ShipLeft0, &ShipLeft1, &ShipLeft2 },
+        { &ShipRight0, &ShipRight1, &ShipRight2 }
+    };
+    const CollisionMask* const bullets[2] = { &PlayerBullet, &EnemyBullet };
+}
@@ -0,0 +1,23 @@
+#include "CollisionMasks.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+bool masksOverlap(const CollisionMask& a, Vec2 aPosition, const CollisionMask& b, Vec2 bPosition) {
+    //b's corner in a's pixels
+    int dx = int(floor(bPosition.x - aPosition.x + 0.5f));
+    int dy = int(floor(bPosition.y - aPosition.y + 0.5f));
+    if (dx >= a.width || dx <= -b.width)
+        return false;
+    //Shift b's rows into a's columns, only the rows both cover need testing
+    int top = max(0, dy), bottom = min(a.height, dy + b.height);
+    for (int y = top; y < bottom; y++) {
+        uint64_t row = b.rows[y - dy];
+        row = dx >= 0 ? row << dx : row >> -dx;
+        if (a.rows[y] & row)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Geometry.h"
+
+enum class BulletSkin : uint8_t; //EntityStore.h, which needs this header
+
+//Which pixels of a sprite can be hit, taken from the alpha of the images in Resources/Images.
+//Row y is one word with bit x set when pixel x is solid, so no sprite can be over 64 pixels
+//either way. Boxes still do the broadphase, the masks are only tested once those overlap.
+//
+//The simulation has no way to load images, so the masks are compiled in from CollisionMaskData.cpp.
+//Run BuildCollisionMasks again after changing any of the images it reads.
+struct CollisionMask {
+    int width, height;
+    Box opaque; //Smallest box around the solid pixels, from the sprite's corner
+    uint64_t rows[64];
+};
+
+namespace CollisionMaskData {
+    extern const CollisionMask* const enemies[3][2]; //[skin - 1][flip], flip 0 is the EnemyN_1 frame
+    extern const Box enemyBoxes[3]; //Both frames of a skin together
+    extern const CollisionMask* const ships[3][3]; //[direction][frame of its animation]
+    extern const CollisionMask* const bullets[2]; //By BulletSkin
+}
+
+inline const CollisionMask& enemyMask(int skin, int flip) {
+    return *CollisionMaskData::enemies[skin - 1][flip];
+}
+inline const Box& enemyOpaqueBox(int skin) {
+    return CollisionMaskData::enemyBoxes[skin - 1];
+}
+inline const CollisionMask& shipMask(int direction, int frame) {
+    return *CollisionMaskData::ships[direction][frame];
+}
+inline const CollisionMask& bulletMask(BulletSkin skin) {
+    return *CollisionMaskData::bullets[int(skin)];
+}
+
+//True when a solid pixel of a, with its corner at aPosition, lands on a solid pixel of b.
+//How far apart they are gets rounded to whole pixels.
+bool masksOverlap(const CollisionMask& a, Vec2 aPosition, const CollisionMask& b, Vec2 bPosition);
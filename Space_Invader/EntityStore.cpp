@@ -0,0 +1,120 @@
+#include "EntityStore.h"
+
+using namespace std;
+
+uint32_t SlotList::allocate() {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = uint32_t(alive.size());
+        alive.push_back(0);
+        generation.push_back(0);
+    }
+    alive[index] = 1;
+    live++;
+    return index;
+}
+
+void SlotList::kill(uint32_t index) {
+    if (!alive[index])
+        return;
+    alive[index] = 0;
+    live--;
+    dying.push_back(index);
+}
+
+void SlotList::collectDead() {
+    for (uint32_t index : dying) {
+        generation[index]++;
+        freeSlots.push_back(index);
+    }
+    dying.clear();
+}
+
+void SlotList::clear() {
+    alive.clear();
+    generation.clear();
+    freeSlots.clear();
+    dying.clear();
+    live = 0;
+}
+
+void SlotList::reserve(size_t capacity) {
+    alive.reserve(capacity);
+    generation.reserve(capacity);
+    freeSlots.reserve(capacity);
+    dying.reserve(capacity);
+}
+
+EntityHandle BulletStore::add(Vec2 position, Vec2 velocity, BulletSkin bulletSkin, bool fromPlayer, uint32_t tint) {
+    uint32_t i = slots.allocate();
+    if (i == x.size()) {
+        x.push_back(0.f), y.push_back(0.f), vx.push_back(0.f), vy.push_back(0.f);
+        previousX.push_back(0.f), previousY.push_back(0.f);
+        color.push_back(0), skin.push_back(bulletSkin), playerOrigin.push_back(0);
+    }
+    x[i] = previousX[i] = position.x;
+    y[i] = previousY[i] = position.y;
+    vx[i] = velocity.x;
+    vy[i] = velocity.y;
+    color[i] = tint;
+    skin[i] = bulletSkin;
+    playerOrigin[i] = fromPlayer;
+    return { i, slots.generation[i] };
+}
+
+void BulletStore::reserve(size_t capacity) {
+    slots.reserve(capacity);
+    x.reserve(capacity), y.reserve(capacity), vx.reserve(capacity), vy.reserve(capacity);
+    previousX.reserve(capacity), previousY.reserve(capacity);
+    color.reserve(capacity), skin.reserve(capacity), playerOrigin.reserve(capacity);
+}
+
+void BulletStore::clear() {
+    slots.clear();
+    x.clear(), y.clear(), vx.clear(), vy.clear();
+    previousX.clear(), previousY.clear();
+    color.clear(), skin.clear(), playerOrigin.clear();
+}
+
+EntityHandle EnemyStore::add(Vec2 position, int moveDirection, int enemyId, int enemySkin, uint32_t tint, int enemyHealth, float enemyBulletSpeed, float enemyFireRate) {
+    uint32_t i = slots.allocate();
+    if (i == x.size()) {
+        x.push_back(0.f), y.push_back(0.f);
+        health.push_back(0), id.push_back(0), skin.push_back(0);
+        color.push_back(0), updating.push_back(0.f), direction.push_back(0), movever.push_back(0), flip.push_back(0);
+        bulletSpeed.push_back(0.f), fireRate.push_back(0.f);
+    }
+    x[i] = position.x;
+    y[i] = position.y;
+    health[i] = enemyHealth;
+    id[i] = enemyId;
+    skin[i] = enemySkin;
+    direction[i] = moveDirection;
+    color[i] = tint;
+    updating[i] = 0.f;
+    movever[i] = 0;
+    flip[i] = 1;
+    bulletSpeed[i] = enemyBulletSpeed;
+    fireRate[i] = enemyFireRate;
+    return { i, slots.generation[i] };
+}
+
+void EnemyStore::reserve(size_t capacity) {
+    slots.reserve(capacity);
+    x.reserve(capacity), y.reserve(capacity);
+    health.reserve(capacity), id.reserve(capacity), skin.reserve(capacity);
+    color.reserve(capacity), updating.reserve(capacity), direction.reserve(capacity), movever.reserve(capacity), flip.reserve(capacity);
+    bulletSpeed.reserve(capacity), fireRate.reserve(capacity);
+}
+
+void EnemyStore::clear() {
+    slots.clear();
+    x.clear(), y.clear();
+    health.clear(), id.clear(), skin.clear();
+    color.clear(), updating.clear(), direction.clear(), movever.clear(), flip.clear();
+    bulletSpeed.clear(), fireRate.clear();
+}
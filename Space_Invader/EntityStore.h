@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CollisionMasks.h"
+#include "Geometry.h"
+
+//Entities are stored structure-of-arrays: one contiguous array per field, indexed by slot.
+//A slot keeps its index for the entity's whole life, so the update and collision loops
+//walk plain float arrays and nothing gets shuffled around when something dies.
+
+//Refers to one entity, goes stale once that entity is removed even if the slot is reused
+struct EntityHandle {
+    uint32_t index;
+    uint32_t generation;
+};
+
+//Slot bookkeeping shared by the stores. Dead slots go on a free list and get handed out again.
+struct SlotList {
+    std::vector<uint8_t> alive;
+    std::vector<uint32_t> generation;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> dying; //Killed this tick, recycled by collectDead()
+    uint32_t live = 0;
+
+    //Returns the slot to use, growing by one when the free list is empty
+    uint32_t allocate();
+    //Marks the slot dead straight away, but it isn't reused until collectDead()
+    void kill(uint32_t index);
+    void collectDead();
+    void clear();
+    void reserve(size_t capacity);
+
+    uint32_t slots() const { return uint32_t(alive.size()); }
+    bool valid(EntityHandle handle) const {
+        return handle.index < alive.size() && alive[handle.index] && generation[handle.index] == handle.generation;
+    }
+};
+
+enum class BulletSkin : uint8_t { PlayerBullet, EnemyBullet };
+
+struct BulletStore {
+    static const int Size = 16;
+
+    SlotList slots;
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> previousX, previousY; //Last tick's position, for interpolated drawing
+    std::vector<uint32_t> color;
+    std::vector<BulletSkin> skin;
+    std::vector<uint8_t> playerOrigin;
+
+    EntityHandle add(Vec2 position, Vec2 velocity, BulletSkin bulletSkin, bool fromPlayer, uint32_t tint);
+    void reserve(size_t capacity);
+    void clear();
+
+    uint32_t size() const { return slots.live; }
+    Vec2 position(uint32_t i) const { return { x[i], y[i] }; }
+    Box getBounds(uint32_t i) const {
+        return { x[i], y[i], float(Size), float(Size) };
+    }
+};
+
+struct EnemyStore {
+    static const int Size = 50;
+
+    SlotList slots;
+    std::vector<float> x, y;
+    std::vector<int> health, id, skin;
+    std::vector<uint32_t> color; //Drawn white instead while updating > 0
+    std::vector<float> updating; //Time left on the white hit flash
+    std::vector<int32_t> direction, movever, flip; //32 bit so the formation kernel can load them as SIMD lanes
+    std::vector<float> bulletSpeed; //How fast this enemy's shots fall
+    std::vector<float> fireRate; //Shots per second
+
+    EntityHandle add(Vec2 position, int moveDirection, int enemyId, int enemySkin, uint32_t tint, int enemyHealth, float enemyBulletSpeed, float enemyFireRate);
+    void reserve(size_t capacity);
+    void clear();
+
+    uint32_t size() const { return slots.live; }
+    Vec2 position(uint32_t i) const { return { x[i], y[i] }; }
+
+    //Just the solid part of the 50x50 sprite, in either frame. The mask decides the actual hit.
+    Box getHitbox(uint32_t i) const {
+        const Box& opaque = enemyOpaqueBox(skin[i]);
+        return { x[i] + opaque.left, y[i] + opaque.top, opaque.width, opaque.height };
+    }
+};
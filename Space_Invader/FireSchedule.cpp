@@ -0,0 +1,38 @@
+#include "FireSchedule.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    //std heaps keep the largest on top, so "later" counts as smaller. The generation breaks the
+    //last tie so the order never depends on how the heap happens to be laid out.
+    bool later(const FireSchedule::Shot& a, const FireSchedule::Shot& b) {
+        if (a.tick != b.tick)
+            return a.tick > b.tick;
+        if (a.enemy.index != b.enemy.index)
+            return a.enemy.index > b.enemy.index;
+        return a.enemy.generation > b.enemy.generation;
+    }
+}
+
+void FireSchedule::schedule(uint64_t tick, EntityHandle enemy) {
+    heap.push_back({ tick, enemy });
+    push_heap(heap.begin(), heap.end(), later);
+}
+
+bool FireSchedule::popDue(uint64_t now, Shot& shot) {
+    if (heap.empty() || heap.front().tick > now)
+        return false;
+    pop_heap(heap.begin(), heap.end(), later);
+    shot = heap.back();
+    heap.pop_back();
+    return true;
+}
+
+void FireSchedule::compact(const SlotList& slots) {
+    if (heap.size() <= 2 * size_t(slots.live) + 64)
+        return;
+    heap.erase(remove_if(heap.begin(), heap.end(), [&](const Shot& shot) { return !slots.valid(shot.enemy); }), heap.end());
+    make_heap(heap.begin(), heap.end(), later);
+}
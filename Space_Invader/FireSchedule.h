@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "EntityStore.h"
+
+//When each enemy shoots next, kept as a min-heap on the tick it's due. Rolling a tiny chance for
+//every enemy every tick and waiting for the first success is the same thing as drawing the wait
+//once from a geometric distribution, so the heap only gets touched when a shot actually happens.
+//
+//Killed enemies aren't taken out, their entries go stale and are skipped when they come up.
+//compact() throws them away once they make up most of the heap.
+struct FireSchedule {
+    struct Shot {
+        uint64_t tick; //Firing tick the shot is due on
+        EntityHandle enemy;
+    };
+
+    std::vector<Shot> heap;
+
+    void reserve(size_t capacity) { heap.reserve(capacity); }
+    void clear() { heap.clear(); }
+    uint32_t size() const { return uint32_t(heap.size()); }
+
+    void schedule(uint64_t tick, EntityHandle enemy);
+
+    //Takes the earliest shot if it's due by now. Shots on the same tick come out in slot order,
+    //the order the old per-enemy loop rolled them in.
+    bool popDue(uint64_t now, Shot& shot);
+
+    //Drops entries for enemies that are gone when there are more of them than live ones
+    void compact(const SlotList& slots);
+};
@@ -0,0 +1,613 @@
+#include "GameSimulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "JobSystem.h"
+#include "Kernels.h"
+#include "Profiler.h"
+
+using namespace std;
+
+namespace {
+    void resetShip(PlayerShip& ship, Vec2 home) {
+        ship.home = home;
+        ship.position = ship.previous = home;
+        ship.velocity = 0.f;
+        ship.direction = 0;
+        ship.animationTime = 0.f;
+        ship.reloading = ship.respawn = ship.invulnerability = 0.f;
+    }
+}
+
+GameSimulation::GameSimulation(uint64_t seed)
+    : coop(false), randomizer(seed), tick(0), stats(), fireTick(0), levels(defaultLevels()), currentLevel(nullptr), nextWave(0), levelEnemies(EnemiesPerLevel), global_score(0), score(0), lives(3), level(1), difficulty(1),
+      endlessTime(0.f), waveTimer(0.f),
+      level_set(true), infinite(false), game_over(false), game_win(false),
+      enemymoving(0.f), starting(0.f) {
+    resetShip(player, { 375.f, 550.f });
+    resetShip(partner, { 295.f, 550.f });
+    enemies.reserve(MaxEndlessEnemies);
+    shots.reserve(2 * MaxEndlessEnemies + 64); //As big as compact() lets it get in endless mode
+    bullets.reserve(MaxEndlessBullets + 64); //Room for the player's shots and one last spread on top of the cap
+    events.reserve(64);
+}
+
+void GameSimulation::start(int startLevel, float introTime) {
+    level = startLevel;
+    level_set = true;
+    starting = introTime;
+}
+
+void GameSimulation::copyStateTo(GameSimulation& into) const {
+    into.player = player;
+    into.partner = partner;
+    into.coop = coop;
+    into.tuning = tuning;
+    into.enemies = enemies;
+    into.bullets = bullets;
+    into.randomizer = randomizer;
+    into.tick = tick;
+    into.stats = stats;
+    into.shots = shots;
+    into.fireTick = fireTick;
+    into.levels = levels;
+    into.activeLevels = activeLevels;
+    into.currentLevel = currentLevel; //Points into activeLevels, which is shared
+    into.nextWave = nextWave;
+    into.levelEnemies = levelEnemies;
+    into.global_score = global_score, into.score = score, into.lives = lives, into.level = level, into.difficulty = difficulty;
+    into.endlessTime = endlessTime, into.waveTimer = waveTimer;
+    into.level_set = level_set, into.infinite = infinite, into.game_over = game_over, into.game_win = game_win;
+    into.enemymoving = enemymoving, into.starting = starting;
+}
+
+void GameSimulation::emit(GameEvent::Type type, int id, Vec2 position) {
+    events.push_back({ type, id, position });
+}
+
+void GameSimulation::spawnBullet(Vec2 position, Vec2 velocity, BulletSkin skin, bool PlayerOrigin, uint32_t color) {
+    bullets.add({ position.x + 17.f, position.y }, velocity, skin, PlayerOrigin, color);
+}
+
+void GameSimulation::spawnEnemy(Vec2 position, int direction, int id, int skin, uint32_t color, int health, float bulletSpeed, float fireRate) {
+    health = max(1, health + tuning.extraHealth);
+    scheduleShot(enemies.add(position, direction, id, skin, color, health, bulletSpeed, fireRate * tuning.fireRateScale));
+}
+
+//The old loop rolled a chance of rate * TickDuration for each enemy every firing tick. The number
+//of failed rolls before a hit is geometric, so one draw here gives the tick the hit would land on.
+void GameSimulation::scheduleShot(EntityHandle enemy) {
+    double chance = min(1.0, double(enemies.fireRate[enemy.index]) * TickDuration);
+    if (chance <= 0.0)
+        return;
+    geometric_distribution<uint64_t> misses(chance);
+    shots.schedule(fireTick + 1 + misses(randomizer), enemy);
+}
+
+namespace {
+    //Items per job when the work is split over threads. Bullet chunks have to be a multiple of 64
+    //so each one fills whole words of the offscreen mask.
+    const uint32_t BulletChunk = 4096;
+    const uint32_t EnemyChunk = 1024;
+    const uint32_t CollisionChunkSize = 1024;
+
+    //Adds the time since the last lap to one of the phase totals and marks it in the profiler,
+    //does nothing when neither is set
+    struct PhaseClock {
+        PhaseTimings* timings;
+        Profiler* profiler;
+        uint64_t last = 0;
+
+        PhaseClock(PhaseTimings* timings, Profiler* profiler)
+            : timings(timings), profiler(profiler) {
+            if (timings)
+                timings->ticks++;
+            if (timings || profiler)
+                last = stamp();
+        }
+
+        uint64_t stamp() const {
+            if (profiler)
+                return profiler->now();
+            return uint64_t(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void lap(uint64_t PhaseTimings::* phase, const char* name) {
+            if (!timings && !profiler)
+                return;
+            uint64_t now = stamp();
+            if (timings)
+                timings->*phase += now - last;
+            if (profiler)
+                profiler->record(name, last, now);
+            last = now;
+        }
+    };
+}
+
+void GameSimulation::step(const InputFrame& input, const InputFrame& partnerInput) {
+    events.clear();
+    tick++;
+
+    if (!playing())
+        return;
+
+    //The level banner freezes everything until it runs out
+    if (starting > 0.f) {
+        starting -= TickDuration;
+        return;
+    }
+
+    if (level_set) {
+        spawnLevel();
+        starting = LevelIntroTime;
+        player.position = player.previous = player.home;
+        partner.position = partner.previous = partner.home;
+        level_set = false;
+        emit(GameEvent::LevelStarted, level, player.position);
+        return;
+    }
+
+    PhaseClock clock(timings, profiler);
+    if (infinite)
+        spawnInfinite();
+    clock.lap(&PhaseTimings::spawn, "spawn");
+    updatePlayer(player, input);
+    if (coop)
+        updatePlayer(partner, partnerInput);
+    clock.lap(&PhaseTimings::movement, "movement");
+    updateEnemies();
+    clock.lap(&PhaseTimings::firing, "firing");
+    stepFormation();
+    updateBullets();
+    clock.lap(&PhaseTimings::movement, "movement");
+    resolveCollisions();
+    clock.lap(&PhaseTimings::collision, "collide");
+    cleanup();
+    clock.lap(&PhaseTimings::cleanup, "cleanup");
+
+    //Next wave of the level once this one is wiped out
+    if (!infinite && !level_set && enemies.size() == 0)
+        spawnWave(nextWave);
+}
+
+void GameSimulation::setLevels(shared_ptr<const LevelSet> newLevels) {
+    levels = move(newLevels);
+}
+
+void GameSimulation::spawnLevel() {
+    if (level == InfiniteLevel) {
+        infinite = true;
+        endlessTime = 0.f;
+        waveTimer = 0.f;
+        return;
+    }
+    activeLevels = levels;
+    currentLevel = activeLevels->find(level);
+    levelEnemies = currentLevel ? currentLevel->enemyCount() : EnemiesPerLevel;
+    spawnWave(0);
+}
+
+void GameSimulation::spawnWave(size_t index) {
+    nextWave = index + 1;
+    if (!currentLevel || index >= currentLevel->waves.size())
+        return;
+    for (const Spawn& spawn : currentLevel->waves[index].spawns) {
+        const EnemyArchetype& archetype = activeLevels->archetypes[spawn.archetype];
+        spawnEnemy(spawn.position, spawn.direction, int(archetype.fire), archetype.skin, archetype.color, archetype.health, archetype.bulletSpeed, archetype.fireRate);
+    }
+}
+
+float GameSimulation::endlessHeat() const {
+    return endlessTime * EndlessHeatPerSecond + global_score * EndlessHeatPerKill;
+}
+
+//Waves come on a timer that shortens as the heat goes up, or straight away when the field is nearly clear
+void GameSimulation::spawnInfinite() {
+    endlessTime += TickDuration;
+    float heat = endlessHeat();
+    //The formation can't step faster than every tick, everything else keeps scaling with heat
+    difficulty = min(tuning.maxDifficulty, int(heat * 100.f));
+
+    waveTimer -= TickDuration;
+    if (waveTimer > 0.f && enemies.size() >= uint32_t(EndlessRefillBelow))
+        return;
+    waveTimer = max(EndlessMinWaveTime, EndlessWaveTime - heat * 0.25f);
+    spawnEndlessWave(heat);
+}
+
+void GameSimulation::spawnEndlessWave(float heat) {
+    static const uint32_t colors[] = { Tint::Green, Tint::Cyan, Tint::Magenta, Tint::Blue, Tint::White, Tint::Yellow, Tint::Red };
+    const int SlotCount = EndlessColumns * EndlessSpawnRows;
+
+    //Mark every slot an enemy overlaps, and which way each row is already walking so new
+    //enemies move with their neighbours instead of through them
+    uint64_t taken = 0;
+    int rowDirection[EndlessSpawnRows] = {};
+    for (uint32_t i = 0, count = enemies.slots.slots(); i < count; i++) {
+        if (!enemies.slots.alive[i])
+            continue;
+        float top = (enemies.y[i] - EndlessTop) / EndlessSlotSize;
+        float left = (enemies.x[i] - 40.f) / EndlessSlotSize;
+        int firstRow = int(floor(top)), lastRow = int(ceil(top + 1.f)) - 1;
+        int firstColumn = int(floor(left)), lastColumn = int(ceil(left + 1.f)) - 1;
+        for (int row = max(firstRow, 0); row <= min(lastRow, EndlessSpawnRows - 1); row++) {
+            for (int column = max(firstColumn, 0); column <= min(lastColumn, EndlessColumns - 1); column++)
+                taken |= uint64_t(1) << (row * EndlessColumns + column);
+            if (firstRow == lastRow)
+                rowDirection[row] = enemies.direction[i];
+        }
+    }
+
+    int freeSlots[SlotCount];
+    int free = 0;
+    for (int slot = 0; slot < SlotCount; slot++) {
+        if (!(taken & (uint64_t(1) << slot)))
+            freeSlots[free++] = slot;
+    }
+
+    int wanted = 5 + int(heat * 2.f);
+    int room = MaxEndlessEnemies - int(enemies.size());
+    int count = min(min(wanted, free), max(room, 0));
+
+    uniform_int_distribution<int> fireRoll(1, 3), skinRoll(1, 3);
+    uint32_t color = colors[min(int(heat), 6)];
+    int health = 1 + int(heat / 3.f);
+    float speedScale = min(2.f, 1.f + heat * 0.05f);
+    for (int n = 0; n < count; n++) {
+        //Partial shuffle, slot n takes a random one of the slots not picked yet
+        uniform_int_distribution<int> pick(n, free - 1);
+        swap(freeSlots[n], freeSlots[pick(randomizer)]);
+        int row = freeSlots[n] / EndlessColumns, column = freeSlots[n] % EndlessColumns;
+        int direction = rowDirection[row] ? rowDirection[row] : row % 2 == 0 ? 1 : -1;
+        int fire = fireRoll(randomizer);
+        Vec2 position = { 40.f + column * EndlessSlotSize, EndlessTop + row * EndlessSlotSize };
+        spawnEnemy(position, direction, fire, skinRoll(randomizer), color, health, EnemyBulletSpeeds[fire] * speedScale, EnemyFireRates[fire]);
+    }
+}
+
+void GameSimulation::updatePlayer(PlayerShip& ship, const InputFrame& input) {
+    int lastDirection = ship.direction;
+    ship.velocity = 0.f;
+    if (input.left && ship.position.x > 40) {
+        ship.velocity = -PlayerSpeed;
+        ship.direction = 1;
+    }
+    else if (input.right && ship.position.x < 640) {
+        ship.velocity = PlayerSpeed;
+        ship.direction = 2;
+    }
+    else
+        ship.direction = 0;
+    //Same timing as the front end's clips, which restart when the direction changes
+    if (ship.direction != lastDirection)
+        ship.animationTime = 0.f;
+    else if ((ship.animationTime += TickDuration) >= ShipFrameTime * ShipFrames)
+        ship.animationTime -= ShipFrameTime * ShipFrames;
+
+    if (ship.reloading <= 0.f) {
+        if (input.fire) {
+            spawnBullet(ship.position, { 0.f, -PlayerBulletSpeed }, BulletSkin::PlayerBullet, true, Tint::Green);
+            ship.reloading = ReloadTime;
+        }
+    }
+    else
+        ship.reloading -= TickDuration;
+
+    ship.previous = ship.position;
+    ship.position.x += ship.velocity * TickDuration;
+
+    if (ship.respawn > 0.f) {
+        ship.respawn -= TickDuration;
+        if (ship.respawn <= 0.f)
+            ship.position = ship.previous = ship.home;
+    }
+    if (ship.invulnerability > 0.f)
+        ship.invulnerability -= TickDuration;
+}
+
+//Omg enemy shooting who tf gave them a gun O_o
+//Only the enemies whose shot is due get looked at, the rest wait in the schedule
+void GameSimulation::updateEnemies() {
+    for (uint32_t i = 0, count = enemies.slots.slots(); i < count; i++) {
+        if (enemies.slots.alive[i] && enemies.updating[i] > 0.f)
+            enemies.updating[i] -= TickDuration;
+    }
+
+    fireTick++;
+    shots.compact(enemies.slots);
+    FireSchedule::Shot shot;
+    while (shots.popDue(fireTick, shot)) {
+        if (!enemies.slots.valid(shot.enemy))
+            continue;
+        uint32_t i = shot.enemy.index;
+        //The next shot is drawn even when this one is held back so the random sequence doesn't depend on the cap
+        scheduleShot(shot.enemy);
+        if (infinite && bullets.size() + 3 > uint32_t(MaxEndlessBullets))
+            continue;
+        Vec2 p = enemies.position(i);
+        int id = enemies.id[i];
+        float speed = enemies.bulletSpeed[i];
+        if (id == 1) {
+            spawnBullet({ p.x - 15.f, p.y }, { 0.f, speed }, BulletSkin::EnemyBullet, false);
+            spawnBullet({ p.x, p.y + 20.f }, { 0.f, speed }, BulletSkin::EnemyBullet, false);
+            spawnBullet({ p.x + 15.f, p.y }, { 0.f, speed }, BulletSkin::EnemyBullet, false);
+        }
+        if (id == 2)
+            spawnBullet(p, { 0.f, speed }, BulletSkin::EnemyBullet, false, Tint::Yellow);
+        if (id == 3) {
+            spawnBullet(p, { speed / 10.f, speed }, BulletSkin::PlayerBullet, false, Tint::Red);
+            spawnBullet(p, { -speed / 10.f, speed }, BulletSkin::PlayerBullet, false, Tint::Red);
+        }
+        emit(GameEvent::EnemyFired, id, p);
+    }
+}
+
+void GameSimulation::stepFormation() {
+    if (enemymoving > 0.f) {
+        enemymoving -= TickDuration;
+        return;
+    }
+    //Dead slots get stepped too, it's cheaper than branching and they're ignored below
+    EnemyStore& e = enemies;
+    FormationArrays arrays = { e.x.data(), e.y.data(), e.direction.data(), e.movever.data(), e.flip.data(), e.slots.slots() };
+    edgeMask.resize(maskWords(arrays.count));
+    bottomMask.resize(maskWords(arrays.count));
+    activeKernels().stepFormation(arrays, edgeMask.data(), bottomMask.data());
+
+    for (uint32_t word = 0; word < bottomMask.size(); word++) {
+        for (uint64_t bits = bottomMask[word]; bits; bits &= bits - 1) {
+            uint32_t i = word * 64 + lowestBit(bits);
+            if (e.slots.alive[i] && !game_over) {
+                game_over = true;
+                emit(GameEvent::GameOver, 0, e.position(i));
+            }
+        }
+    }
+    enemymoving = EnemyStepTime * (1000 - difficulty) / 1000.f; //Reset the last move time
+}
+
+void GameSimulation::updateBullets() {
+    BulletStore& b = bullets;
+    BulletArrays arrays = { b.x.data(), b.y.data(), b.vx.data(), b.vy.data(), b.previousX.data(), b.previousY.data(), b.slots.slots() };
+    offscreenMask.resize(maskWords(arrays.count));
+    if (jobs) {
+        //Chunks are whole mask words so no two threads write the same word
+        jobs->parallelFor(arrays.count, BulletChunk, [&](uint32_t begin, uint32_t end) {
+            BulletArrays part = { arrays.x + begin, arrays.y + begin, arrays.vx + begin, arrays.vy + begin,
+                arrays.previousX + begin, arrays.previousY + begin, end - begin };
+            activeKernels().integrateBullets(part, TickDuration, PlayfieldHeight, offscreenMask.data() + begin / 64);
+        });
+    }
+    else
+        activeKernels().integrateBullets(arrays, TickDuration, PlayfieldHeight, offscreenMask.data());
+
+    //Only the bullets that left the screen need any scalar work
+    for (uint32_t word = 0; word < offscreenMask.size(); word++) {
+        for (uint64_t bits = offscreenMask[word]; bits; bits &= bits - 1)
+            b.slots.kill(word * 64 + lowestBit(bits));
+    }
+}
+
+void GameSimulation::resolveCollisions() {
+    if (jobs) {
+        resolveCollisionsParallel();
+        return;
+    }
+    stats.pairTests = 0;
+
+    enemyBoxes.resize(enemies.slots.slots());
+    for (uint32_t i = 0; i < enemyBoxes.size(); i++)
+        enemyBoxes[i] = enemies.getHitbox(i);
+    grid.build(enemyBoxes, enemies.slots.alive);
+
+    Box playerBounds = player.getBounds();
+    Box partnerBounds = partner.getBounds();
+    for (uint32_t i = 0, count = bullets.slots.slots(); i < count; i++) {
+        if (!bullets.slots.alive[i])
+            continue;
+        Box bounds = bullets.getBounds(i);
+        //Player bullets only look at enemies sharing a cell, enemy bullets only at the ships
+        if (bullets.playerOrigin[i]) {
+            grid.query(bounds, [&](uint32_t enemy) {
+                stats.pairTests++;
+                if (enemies.slots.alive[enemy] && bounds.intersects(enemyBoxes[enemy]) && touchesEnemy(i, enemy))
+                    hitEnemy(i, enemy);
+            });
+            continue;
+        }
+        if (player.invulnerability <= 0.f) {
+            stats.pairTests++;
+            if (bounds.intersects(playerBounds) && touchesShip(i, player)) {
+                hitPlayer(i, player);
+                playerBounds = player.getBounds();
+                continue;
+            }
+        }
+        if (coop && partner.invulnerability <= 0.f) {
+            stats.pairTests++;
+            if (bounds.intersects(partnerBounds) && touchesShip(i, partner)) {
+                hitPlayer(i, partner);
+                partnerBounds = partner.getBounds();
+            }
+        }
+    }
+    stats.totalPairTests += stats.pairTests;
+}
+
+//Same outcome as resolveCollisions(). The tests only read the state the tick started with, so they
+//run in parallel and list what they found per chunk. The hits are then applied one at a time in
+//bullet order, rechecking anything an earlier hit could have changed, exactly like the serial loop.
+void GameSimulation::resolveCollisionsParallel() {
+    stats.pairTests = 0;
+
+    enemyBoxes.resize(enemies.slots.slots());
+    jobs->parallelFor(uint32_t(enemyBoxes.size()), EnemyChunk, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            enemyBoxes[i] = enemies.getHitbox(i);
+    });
+    grid.build(enemyBoxes, enemies.slots.alive);
+    const CollisionGrid& sharedGrid = grid;
+
+    uint32_t count = bullets.slots.slots();
+    collisionChunks.resize(JobSystem::chunkCount(count, CollisionChunkSize));
+    const Box playerBounds = player.getBounds(), partnerBounds = partner.getBounds();
+    //Can only turn false during the merge
+    const bool playerTargetable = player.invulnerability <= 0.f;
+    const bool partnerTargetable = coop && partner.invulnerability <= 0.f;
+    jobs->parallelFor(count, CollisionChunkSize, [&](uint32_t begin, uint32_t end) {
+        CollisionChunk& chunk = collisionChunks[begin / CollisionChunkSize];
+        chunk.hits.clear();
+        chunk.pairTests = 0;
+        chunk.enemyBullets = 0;
+        for (uint32_t i = begin; i < end; i++) {
+            if (!bullets.slots.alive[i])
+                continue;
+            Box bounds = bullets.getBounds(i);
+            if (bullets.playerOrigin[i]) {
+                sharedGrid.query(bounds, [&](uint32_t enemy) {
+                    chunk.pairTests++;
+                    if (enemies.slots.alive[enemy] && bounds.intersects(enemyBoxes[enemy]) && touchesEnemy(i, enemy))
+                        chunk.hits.push_back({ i, enemy, 0, 0 });
+                }, chunk.stamps);
+            }
+            else {
+                uint8_t ships = 0;
+                if (playerTargetable && bounds.intersects(playerBounds) && touchesShip(i, player))
+                    ships |= CollisionChunk::HitsPlayer;
+                if (partnerTargetable && bounds.intersects(partnerBounds) && touchesShip(i, partner))
+                    ships |= CollisionChunk::HitsPartner;
+                if (ships)
+                    chunk.hits.push_back({ i, CollisionChunk::ShipTarget, chunk.enemyBullets, ships });
+                chunk.enemyBullets++;
+            }
+        }
+    });
+
+    for (const CollisionChunk& chunk : collisionChunks) {
+        stats.pairTests += chunk.pairTests;
+        //Enemy bullets are only tested against a ship while it can be hit, which stops at its
+        //first hit. A bullet that hits the player never gets tested against the partner.
+        bool testingPartner = coop && partner.invulnerability <= 0.f;
+        uint32_t playerTests = player.invulnerability <= 0.f ? chunk.enemyBullets : 0;
+        uint32_t partnerTests = testingPartner ? chunk.enemyBullets : 0, partnerSkips = 0;
+        for (const CollisionChunk::Hit& hit : chunk.hits) {
+            if (hit.enemy != CollisionChunk::ShipTarget) {
+                if (enemies.slots.alive[hit.enemy])
+                    hitEnemy(hit.bullet, hit.enemy);
+            }
+            else if ((hit.ships & CollisionChunk::HitsPlayer) && player.invulnerability <= 0.f) {
+                playerTests = hit.enemyBullets + 1;
+                if (testingPartner && partner.invulnerability <= 0.f)
+                    partnerSkips++;
+                hitPlayer(hit.bullet, player);
+            }
+            else if ((hit.ships & CollisionChunk::HitsPartner) && partner.invulnerability <= 0.f) {
+                partnerTests = hit.enemyBullets + 1;
+                hitPlayer(hit.bullet, partner);
+            }
+        }
+        stats.pairTests += playerTests + partnerTests - partnerSkips;
+    }
+    stats.totalPairTests += stats.pairTests;
+}
+
+bool GameSimulation::touchesEnemy(uint32_t bullet, uint32_t enemy) const {
+    return masksOverlap(bulletMask(bullets.skin[bullet]), bullets.position(bullet), enemyMask(enemies.skin[enemy], enemies.flip[enemy]), enemies.position(enemy));
+}
+
+bool GameSimulation::touchesShip(uint32_t bullet, const PlayerShip& ship) const {
+    return masksOverlap(bulletMask(bullets.skin[bullet]), bullets.position(bullet), shipMask(ship.direction, ship.frame()), ship.position);
+}
+
+void GameSimulation::hitEnemy(uint32_t bullet, uint32_t enemy) {
+    //Collision detected, remove the bullet and reduce health
+    bullets.slots.kill(bullet);
+    enemies.health[enemy]--;
+    if (enemies.health[enemy] > 0) {
+        enemies.updating[enemy] = EnemyFlashTime;
+        emit(GameEvent::EnemyHit, enemies.id[enemy], enemies.position(enemy));
+        return;
+    }
+    enemies.slots.kill(enemy);
+    global_score++;
+    score++;
+    emit(GameEvent::EnemyKilled, enemies.id[enemy], enemies.position(enemy));
+    if (!infinite && score == levelEnemies) {
+        if (level != activeLevels->lastLevel()) {
+            level++;
+            level_set = true;
+            score = 0;
+        }
+        else {
+            game_win = true;
+            emit(GameEvent::GameWon, level, enemies.position(enemy));
+        }
+    }
+    if (!infinite)
+        difficulty = min(tuning.maxDifficulty, tuning.difficultyPerKill * score);
+}
+
+void GameSimulation::hitPlayer(uint32_t bullet, PlayerShip& ship) {
+    lives--;
+    bullets.slots.kill(bullet);
+    emit(GameEvent::PlayerHit, ship.direction, ship.position);
+    ship.invulnerability = InvulnerableTime;
+    ship.position = ship.previous = { ship.home.x, -100.f };
+    ship.respawn = RespawnTime;
+    if (lives == 0) {
+        game_over = true;
+        emit(GameEvent::GameOver, 0, ship.position);
+    }
+}
+
+//Slots killed this tick go back on the free lists, nothing gets moved
+void GameSimulation::cleanup() {
+    enemies.slots.collectDead();
+    bullets.slots.collectDead();
+}
+
+namespace {
+    //FNV-1a, fed one field at a time
+    struct Hasher {
+        uint64_t value = 14695981039346656037ull;
+
+        template <typename T>
+        void add(const T& field) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&field);
+            for (size_t i = 0; i < sizeof(T); i++) {
+                value ^= bytes[i];
+                value *= 1099511628211ull;
+            }
+        }
+    };
+}
+
+uint64_t GameSimulation::checksum() const {
+    Hasher hash;
+    hash.add(tick);
+    hash.add(player.position.x), hash.add(player.position.y), hash.add(player.direction);
+    hash.add(global_score), hash.add(lives), hash.add(level), hash.add(game_over), hash.add(game_win);
+    hash.add(player.reloading), hash.add(player.respawn), hash.add(player.invulnerability), hash.add(player.animationTime);
+    //Only hashed in co-op so solo runs keep the checksums they always had
+    if (coop) {
+        hash.add(partner.position.x), hash.add(partner.position.y), hash.add(partner.direction);
+        hash.add(partner.reloading), hash.add(partner.respawn), hash.add(partner.invulnerability), hash.add(partner.animationTime);
+    }
+    for (uint32_t i = 0; i < enemies.slots.slots(); i++) {
+        if (!enemies.slots.alive[i])
+            continue;
+        hash.add(i), hash.add(enemies.x[i]), hash.add(enemies.y[i]), hash.add(enemies.health[i]);
+    }
+    for (uint32_t i = 0; i < bullets.slots.slots(); i++) {
+        if (!bullets.slots.alive[i])
+            continue;
+        hash.add(i), hash.add(bullets.x[i]), hash.add(bullets.y[i]);
+    }
+    //The generator's next number stands in for its whole state
+    mt19937_64 generator = randomizer;
+    hash.add(generator());
+    return hash.value;
+}
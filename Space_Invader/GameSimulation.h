@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "CollisionGrid.h"
+#include "EntityStore.h"
+#include "FireSchedule.h"
+#include "Geometry.h"
+#include "LevelSet.h"
+
+class JobSystem;
+class Profiler;
+
+//Everything in here is plain C++ with no SFML, so the game rules can run headless
+//(tests, benchmarks, replays) at whatever speed the CPU allows.
+
+//Gameplay runs on a fixed timestep so speed doesn't depend on how fast the loop spins.
+//The old frame counters assumed roughly one loop per millisecond, so 1000 frames became 1 second.
+const float TickRate = 120.f;
+const float TickDuration = 1.f / TickRate;
+
+const float PlayerSpeed = 320.f;
+const float PlayerBulletSpeed = 480.f;
+const float ReloadTime = 1.f;
+const float RespawnTime = 1.f;
+const float InvulnerableTime = 3.f;
+const float EnemyStepTime = 1.f;
+const float EnemyFlashTime = 0.05f;
+const float EnemyFireRate = 0.01f; //Shots per second per enemy
+const float GameStartIntroTime = 0.6f;
+const float LevelIntroTime = 1.f;
+const float ShipFrameTime = 0.09f; //Each ship animation is ShipFrames frames this long, on a loop
+const int ShipFrames = 3;
+
+const int EnemiesPerLevel = 55; //Fallback when a level number isn't in the level set
+const int InfiniteLevel = 5;
+
+//Endless mode drops formations into free slots of a grid lined up with the formation edges,
+//13 columns from x = 40 to 640 and EndlessSpawnRows rows from y = 100 down.
+//Difficulty ("heat") grows with time and kills without a cap, the entity caps keep the cost bounded.
+const int EndlessColumns = 13;
+const int EndlessSpawnRows = 3;
+const float EndlessTop = 100.f;
+const float EndlessSlotSize = 50.f;
+const int MaxEndlessEnemies = 256;
+const int MaxEndlessBullets = 256; //Enemies hold fire while this many bullets are up
+const float EndlessWaveTime = 6.f; //Seconds between waves at heat 0
+const float EndlessMinWaveTime = 1.5f;
+const int EndlessRefillBelow = 4; //A new wave comes early once the field is this empty
+const float EndlessHeatPerSecond = 1.f / 30.f;
+const float EndlessHeatPerKill = 1.f / 40.f;
+
+//Bullet speed and shots per second for each fire pattern when an enemy doesn't come from a level file
+const float EnemyBulletSpeeds[] = { 0.f, 320.f, 480.f, 320.f };
+const float EnemyFireRates[] = { EnemyFireRate, EnemyFireRate, EnemyFireRate, EnemyFireRate };
+
+//Colours are packed 0xRRGGBBAA so the renderer can hand them straight to sf::Color
+namespace Tint {
+    const uint32_t White = 0xFFFFFFFF;
+    const uint32_t Red = 0xFF0000FF;
+    const uint32_t Green = 0x00FF00FF;
+    const uint32_t Blue = 0x0000FFFF;
+    const uint32_t Yellow = 0xFFFF00FF;
+    const uint32_t Magenta = 0xFF00FFFF;
+    const uint32_t Cyan = 0x00FFFFFF;
+}
+
+//What the player is pressing during one tick
+struct InputFrame {
+    bool left = false;
+    bool right = false;
+    bool fire = false;
+};
+
+struct PlayerShip {
+    Vec2 position, previous;
+    Vec2 home; //Where it comes back in at the start of a level and after being hit
+    float velocity;
+    int direction; //0 idle, 1 turning left, 2 turning right
+    float animationTime; //Since the animation of this direction started, wraps around
+    float reloading, respawn, invulnerability;
+
+    //The frame on screen, hits are tested against its mask
+    int frame() const { return int(animationTime / ShipFrameTime) % ShipFrames; }
+
+    //No modified hitbox for the player because they don't deserve any mercy >:)
+    //(The collision mask only counts the pixels of the ship that are actually there though)
+    Box getBounds() const {
+        return { position.x, position.y, direction == 0 ? 50.f : 42.f, 34.f };
+    }
+};
+
+//Things the front end reacts to with sounds and explosions
+struct GameEvent {
+    enum Type : uint8_t { EnemyFired, EnemyHit, EnemyKilled, PlayerHit, LevelStarted, GameOver, GameWon };
+    Type type;
+    int id; //Enemy id for EnemyFired, ship direction for PlayerHit (either ship), level for LevelStarted
+    Vec2 position;
+};
+
+//Balance knobs, the defaults are the game as it ships. BalanceSweep runs the bot over grids of these.
+struct Tuning {
+    int difficultyPerKill = 20; //Formation speed up per kill on the current level, out of 1000
+    int maxDifficulty = 975; //At 1000 the formation would step every tick
+    float fireRateScale = 1.f; //Multiplies every enemy's shots per second
+    int extraHealth = 0; //Added to every enemy's health, can't take it below 1
+};
+
+struct SimulationStats {
+    uint64_t pairTests; //Box tests done by the last step
+    uint64_t totalPairTests;
+};
+
+//Time spent in each part of step(), only measured while GameSimulation::timings points somewhere
+struct PhaseTimings {
+    uint64_t spawn = 0; //Nanoseconds, summed over every timed tick
+    uint64_t movement = 0;
+    uint64_t firing = 0;
+    uint64_t collision = 0;
+    uint64_t cleanup = 0;
+    uint64_t ticks = 0;
+
+    uint64_t total() const { return spawn + movement + firing + collision + cleanup; }
+};
+
+//What one chunk of bullets found during a parallel collision pass, merged in chunk order
+struct CollisionChunk {
+    static const uint32_t ShipTarget = UINT32_MAX;
+    static const uint8_t HitsPlayer = 1, HitsPartner = 2;
+
+    struct Hit {
+        uint32_t bullet;
+        uint32_t enemy; //ShipTarget for an enemy bullet touching a ship
+        uint32_t enemyBullets; //Enemy bullets in the chunk before this one, for the pair test count
+        uint8_t ships; //HitsPlayer | HitsPartner, which ships it touched when enemy is ShipTarget
+    };
+    std::vector<Hit> hits;
+    uint64_t pairTests; //Player bullet tests, enemy bullets are counted at the merge
+    uint32_t enemyBullets;
+    CollisionGrid::QueryStamps stamps;
+};
+
+struct GameSimulation {
+    PlayerShip player;
+    PlayerShip partner; //The second ship in co-op, left out of everything otherwise
+    bool coop; //Lives and score are shared between the ships
+    EnemyStore enemies;
+    BulletStore bullets;
+    std::vector<GameEvent> events; //Cleared at the start of every step
+    Tuning tuning;
+
+    std::mt19937_64 randomizer;
+    uint64_t tick;
+    SimulationStats stats;
+    PhaseTimings* timings = nullptr; //Not owned, set by benchmarks
+    Profiler* profiler = nullptr; //Not owned, marks each phase of step() when set
+    //Not owned. When set, bullet movement and the collision tests are split over its threads.
+    //Results come out the same as without it, bit for bit, whatever the thread count.
+    JobSystem* jobs = nullptr;
+
+    //Broadphase for player bullets, enemyBoxes[i] is the hitbox of enemy slot i
+    CollisionGrid grid;
+    std::vector<Box> enemyBoxes;
+    std::vector<CollisionChunk> collisionChunks;
+
+    //Next shot of every enemy. fireTick counts the ticks enemies were able to shoot on, so time
+    //spent frozen in a level banner doesn't bring shots forward.
+    FireSchedule shots;
+    uint64_t fireTick;
+
+    //Bit i set = slot i, filled in by the movement kernels
+    std::vector<uint64_t> offscreenMask, edgeMask, bottomMask;
+
+    //Formations come from here. setLevels() takes effect at the next level, the one being played
+    //keeps using the set it was spawned from.
+    std::shared_ptr<const LevelSet> levels, activeLevels;
+    const LevelDefinition* currentLevel;
+    size_t nextWave;
+    int levelEnemies; //Kills needed to finish the current level
+
+    int global_score, score, lives, level, difficulty;
+    float endlessTime, waveTimer; //Endless mode only
+    bool level_set, infinite, game_over, game_win;
+    float enemymoving, starting;
+
+    explicit GameSimulation(uint64_t seed);
+
+    //Begins a run at the given level after an optional intro delay
+    void start(int startLevel, float introTime = GameStartIntroTime);
+
+    //Advances the game by exactly one TickDuration. partnerInput only matters in co-op.
+    void step(const InputFrame& input, const InputFrame& partnerInput = InputFrame());
+
+    //Copies everything the game plays out from into another simulation, for saving and restoring
+    //states (rollback). Scratch buffers that step() rebuilds and the timings, profiler and jobs
+    //pointers stay as they are. Reuses the target's memory, so once it has grown this doesn't allocate.
+    void copyStateTo(GameSimulation& into) const;
+
+    bool playing() const { return !game_over && !game_win; }
+    bool inIntro() const { return starting > 0.f; }
+
+    //Hash of the state that matters for determinism, two runs that agree here have played out the same
+    uint64_t checksum() const;
+
+    //The step is split into phases so they can be profiled on their own
+    void setLevels(std::shared_ptr<const LevelSet> newLevels);
+    void spawnLevel();
+    void spawnWave(size_t index);
+    void spawnInfinite();
+    void spawnEndlessWave(float heat);
+    float endlessHeat() const;
+    void updatePlayer(PlayerShip& ship, const InputFrame& input);
+    void updateEnemies();
+    void stepFormation();
+    void updateBullets();
+    void resolveCollisions();
+    void resolveCollisionsParallel();
+    //Narrow phase, only called once the boxes overlap
+    bool touchesEnemy(uint32_t bullet, uint32_t enemy) const;
+    bool touchesShip(uint32_t bullet, const PlayerShip& ship) const;
+    void hitEnemy(uint32_t bullet, uint32_t enemy);
+    void hitPlayer(uint32_t bullet, PlayerShip& ship);
+    void cleanup();
+
+    void spawnBullet(Vec2 position, Vec2 velocity, BulletSkin skin, bool PlayerOrigin, uint32_t color = Tint::White);
+    void spawnEnemy(Vec2 position, int direction, int id, int skin, uint32_t color, int health, float bulletSpeed, float fireRate);
+    void scheduleShot(EntityHandle enemy);
+    void emit(GameEvent::Type type, int id, Vec2 position);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+constexpr float PlayfieldWidth = 720.f;
+constexpr float PlayfieldHeight = 720.f;
+
+struct Vec2 {
+    float x, y;
+};
+
+//Axis aligned box, same overlap rule as sf::Rect::intersects
+struct Box {
+    float left, top, width, height;
+
+    bool intersects(const Box& other) const {
+        return left < other.left + other.width && other.left < left + width
+            && top < other.top + other.height && other.top < top + height;
+    }
+};
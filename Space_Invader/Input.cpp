@@ -0,0 +1,154 @@
+#include "Input.h"
+
+using namespace std;
+using namespace sf;
+
+const float Input::AxisThreshold = 50.f;
+const float Input::AxisRelease = 30.f;
+
+Input::Input(int joystick) {
+    //Arrows or A/D to move, Up or Z to shoot, same as the old polling
+    bindKey(Keyboard::Left, Action::Left);
+    bindKey(Keyboard::A, Action::Left);
+    bindKey(Keyboard::Right, Action::Right);
+    bindKey(Keyboard::D, Action::Right);
+    bindKey(Keyboard::Up, Action::Up);
+    bindKey(Keyboard::Down, Action::Down);
+    bindKey(Keyboard::Up, Action::Fire);
+    bindKey(Keyboard::Z, Action::Fire);
+    bindKey(Keyboard::Space, Action::Fire);
+    bindKey(Keyboard::Enter, Action::Confirm);
+    bindKey(Keyboard::Escape, Action::Back);
+
+    //Xbox style layout: A shoots and confirms, B goes back, Start confirms
+    bindButton(joystick, 0, Action::Fire);
+    bindButton(joystick, 0, Action::Confirm);
+    bindButton(joystick, 1, Action::Back);
+    bindButton(joystick, 7, Action::Confirm);
+    bindAxis(joystick, Joystick::X, -1.f, Action::Left);
+    bindAxis(joystick, Joystick::X, 1.f, Action::Right);
+    bindAxis(joystick, Joystick::Y, -1.f, Action::Up);
+    bindAxis(joystick, Joystick::Y, 1.f, Action::Down);
+    //The d-pad comes through as the POV axes, with up positive
+    bindAxis(joystick, Joystick::PovX, -1.f, Action::Left);
+    bindAxis(joystick, Joystick::PovX, 1.f, Action::Right);
+    bindAxis(joystick, Joystick::PovY, 1.f, Action::Up);
+    bindAxis(joystick, Joystick::PovY, -1.f, Action::Down);
+
+    //Holding a direction in the menus steps through it, a bit slower than the old 0.2s sleep to start with
+    setRepeat(Action::Up, 0.4f, 0.15f);
+    setRepeat(Action::Down, 0.4f, 0.15f);
+}
+
+void Input::bindKey(Keyboard::Key key, Action action) {
+    bindings.push_back({ Source::Key, int(key), AnyJoystick, 1.f, action });
+}
+
+void Input::bindButton(int joystick, unsigned button, Action action) {
+    bindings.push_back({ Source::Button, int(button), joystick, 1.f, action });
+}
+
+void Input::bindAxis(int joystick, Joystick::Axis axis, float direction, Action action) {
+    bindings.push_back({ Source::Axis, int(axis), joystick, direction, action });
+}
+
+void Input::clearBindings() {
+    releaseAll();
+    bindings.clear();
+}
+
+void Input::setRepeat(Action action, float delay, float interval) {
+    actions[size_t(action)].repeat = { delay, interval > 0.f ? interval : delay };
+}
+
+void Input::setActive(Binding& binding, bool active) {
+    if (binding.active == active)
+        return;
+    binding.active = active;
+    State& state = actions[size_t(binding.action)];
+    if (active) {
+        //Only the first binding to go down counts as a press
+        if (state.held++ == 0) {
+            state.fresh = true;
+            state.tapped = true;
+            state.repeatTimer = state.repeat.delay;
+        }
+    }
+    else
+        state.held--;
+}
+
+void Input::handleEvent(const Event& event) {
+    switch (event.type) {
+    case Event::KeyPressed:
+    case Event::KeyReleased:
+        for (auto& binding : bindings) {
+            if (binding.source == Source::Key && binding.code == int(event.key.code))
+                setActive(binding, event.type == Event::KeyPressed);
+        }
+        break;
+    case Event::JoystickButtonPressed:
+    case Event::JoystickButtonReleased:
+        for (auto& binding : bindings) {
+            if (binding.source == Source::Button && binding.code == int(event.joystickButton.button) && fromPad(binding, event.joystickButton.joystickId))
+                setActive(binding, event.type == Event::JoystickButtonPressed);
+        }
+        break;
+    case Event::JoystickMoved:
+        for (auto& binding : bindings) {
+            if (binding.source != Source::Axis || binding.code != int(event.joystickMove.axis) || !fromPad(binding, event.joystickMove.joystickId))
+                continue;
+            float position = event.joystickMove.position * binding.direction;
+            if (!binding.active && position >= AxisThreshold)
+                setActive(binding, true);
+            else if (binding.active && position < AxisRelease)
+                setActive(binding, false);
+        }
+        break;
+    case Event::JoystickDisconnected:
+        for (auto& binding : bindings) {
+            if (binding.source != Source::Key && fromPad(binding, event.joystickConnect.joystickId))
+                setActive(binding, false);
+        }
+        break;
+    case Event::LostFocus:
+        releaseAll();
+        break;
+    default:
+        break;
+    }
+}
+
+void Input::update(float deltaTime) {
+    for (auto& state : actions) {
+        state.pressed = state.fresh;
+        state.fresh = false;
+        if (state.pressed || state.held == 0 || state.repeat.delay <= 0.f)
+            continue;
+        state.repeatTimer -= deltaTime;
+        if (state.repeatTimer <= 0.f) {
+            state.pressed = true;
+            state.repeatTimer += state.repeat.interval;
+        }
+    }
+}
+
+InputFrame Input::tickInput() {
+    InputFrame frame;
+    frame.left = held(Action::Left);
+    frame.right = held(Action::Right);
+    State& fire = actions[size_t(Action::Fire)];
+    frame.fire = fire.held > 0 || fire.tapped;
+    fire.tapped = false;
+    return frame;
+}
+
+void Input::clearTaps() {
+    for (auto& state : actions)
+        state.tapped = false;
+}
+
+void Input::releaseAll() {
+    for (auto& binding : bindings)
+        setActive(binding, false);
+}
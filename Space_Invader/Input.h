@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <SFML/Window.hpp>
+
+#include "GameSimulation.h"
+
+//What the game cares about, separate from which key or button produced it
+enum class Action { Left, Right, Up, Down, Fire, Confirm, Back, Count };
+
+//Input built from the window's events instead of polling the keyboard. Every binding tracks
+//whether it's held, so an action is down while any of its bindings is. Presses are edges
+//(seen once, on the frame they happen) and can repeat while held, so menus don't need to
+//sleep between moves. Call handleEvent() for every polled event, update() once a frame,
+//then read pressed()/held() and take the gameplay input with tickInput().
+class Input {
+public:
+    struct Repeat {
+        float delay = 0.f; //Seconds held before the first repeat, 0 turns repeating off
+        float interval = 0.f;
+    };
+
+    static const int AnyJoystick = -1;
+
+    //The default bindings read the gamepad with this id, other pads are ignored
+    explicit Input(int joystick = 0);
+
+    //The action map. Several bindings can drive one action and one key can drive several actions.
+    //Gamepad bindings belong to one pad by its SFML id, or to every pad with AnyJoystick.
+    void bindKey(sf::Keyboard::Key key, Action action);
+    void bindButton(int joystick, unsigned button, Action action);
+    void bindAxis(int joystick, sf::Joystick::Axis axis, float direction, Action action); //direction is +1 or -1
+    void clearBindings();
+    void setRepeat(Action action, float delay, float interval);
+
+    void handleEvent(const sf::Event& event);
+    void update(float deltaTime); //Repeats, and clears last frame's presses
+
+    bool held(Action action) const { return actions[size_t(action)].held > 0; }
+    bool pressed(Action action) const { return actions[size_t(action)].pressed; }
+
+    //Fire counts if it was held or tapped at any point since the last tick, so a press
+    //shorter than a tick still shoots. Each tick takes the taps with it.
+    InputFrame tickInput();
+    //Forgets taps no tick has taken yet, for when a run starts after the menu
+    void clearTaps();
+
+    //Lets go of everything, for when the window loses focus and the releases won't arrive
+    void releaseAll();
+
+    static const float AxisThreshold; //Percent a stick has to move before it counts
+    static const float AxisRelease; //And how far it has to come back, so it doesn't flicker at the edge
+
+private:
+    enum class Source { Key, Button, Axis };
+    struct Binding {
+        Source source;
+        int code; //Key, button or axis
+        int joystick; //Pad id for buttons and axes
+        float direction;
+        Action action;
+        bool active = false;
+    };
+    struct State {
+        int held = 0; //Active bindings
+        bool pressed = false; //This frame
+        bool fresh = false; //Pressed during handleEvent, becomes pressed at update()
+        bool tapped = false; //Since the last tick
+        float repeatTimer = 0.f;
+        Repeat repeat;
+    };
+
+    void setActive(Binding& binding, bool active);
+    static bool fromPad(const Binding& binding, unsigned joystick) {
+        return binding.joystick == AnyJoystick || binding.joystick == int(joystick);
+    }
+
+    std::vector<Binding> bindings;
+    std::array<State, size_t(Action::Count)> actions;
+};
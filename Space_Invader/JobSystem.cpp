@@ -0,0 +1,127 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    //How long an idle worker keeps checking for work before it sleeps. Ticks come every 8 ms,
+    //so it sleeps between them and only spins through the gaps inside one.
+    const int SpinCount = 4000;
+
+    uint64_t pack(uint32_t begin, uint32_t end) {
+        return uint64_t(begin) << 32 | end;
+    }
+    uint32_t rangeBegin(uint64_t range) {
+        return uint32_t(range >> 32);
+    }
+    uint32_t rangeEnd(uint64_t range) {
+        return uint32_t(range);
+    }
+}
+
+JobSystem::JobSystem(unsigned threads) {
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    queues.reset(new Queue[threads]);
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        lock_guard<mutex> lock(sleepLock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void JobSystem::run(uint32_t itemCount, uint32_t chunkSize, RangeFunction call, void* callContext) {
+    uint32_t chunks = chunkCount(itemCount, chunkSize);
+    if (chunks == 0)
+        return;
+    if (workers.empty() || chunks == 1) {
+        for (uint32_t chunk = 0; chunk < chunks; chunk++)
+            call(callContext, chunk * chunkSize, min(itemCount, (chunk + 1) * chunkSize));
+        return;
+    }
+
+    function = call;
+    context = callContext;
+    count = itemCount;
+    grain = chunkSize;
+    unsigned threads = threadCount();
+    for (unsigned i = 0; i < threads; i++)
+        queues[i].range.store(pack(uint32_t(uint64_t(chunks) * i / threads), uint32_t(uint64_t(chunks) * (i + 1) / threads)), memory_order_relaxed);
+    remaining.store(chunks, memory_order_relaxed);
+    finished.store(0, memory_order_relaxed);
+    {
+        lock_guard<mutex> lock(sleepLock);
+        generation.fetch_add(1, memory_order_release);
+    }
+    wake.notify_all();
+
+    work(0);
+    //Every worker has to check in before the job fields can be reused for the next call
+    while (remaining.load(memory_order_acquire) != 0 || finished.load(memory_order_acquire) != workers.size())
+        this_thread::yield();
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    uint64_t seen = 0;
+    while (true) {
+        for (int spin = 0; spin < SpinCount && generation.load(memory_order_acquire) == seen; spin++)
+            this_thread::yield();
+        if (generation.load(memory_order_acquire) == seen) {
+            unique_lock<mutex> lock(sleepLock);
+            wake.wait(lock, [&]() { return quit || generation.load(memory_order_acquire) != seen; });
+            if (quit)
+                return;
+        }
+        seen = generation.load(memory_order_acquire);
+        work(index);
+        finished.fetch_add(1, memory_order_release);
+    }
+}
+
+void JobSystem::work(unsigned index) {
+    uint32_t chunk;
+    while (take(index, chunk) || steal(index, chunk)) {
+        function(context, chunk * grain, min(count, (chunk + 1) * grain));
+        remaining.fetch_sub(1, memory_order_release);
+    }
+}
+
+//Front of our own run
+bool JobSystem::take(unsigned index, uint32_t& chunk) {
+    atomic<uint64_t>& range = queues[index].range;
+    uint64_t current = range.load(memory_order_acquire);
+    while (rangeBegin(current) < rangeEnd(current)) {
+        if (range.compare_exchange_weak(current, pack(rangeBegin(current) + 1, rangeEnd(current)), memory_order_acq_rel)) {
+            chunk = rangeBegin(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+//Back half of the first run that still has chunks, the rest of it becomes our own run
+bool JobSystem::steal(unsigned thief, uint32_t& chunk) {
+    unsigned threads = threadCount();
+    for (unsigned offset = 1; offset < threads; offset++) {
+        atomic<uint64_t>& range = queues[(thief + offset) % threads].range;
+        uint64_t current = range.load(memory_order_acquire);
+        while (rangeBegin(current) < rangeEnd(current)) {
+            uint32_t begin = rangeBegin(current), end = rangeEnd(current);
+            uint32_t middle = begin + (end - begin) / 2;
+            if (range.compare_exchange_weak(current, pack(begin, middle), memory_order_acq_rel)) {
+                chunk = middle;
+                queues[thief].range.store(pack(middle + 1, end), memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
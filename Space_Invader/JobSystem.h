@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//A small pool of worker threads for splitting a loop over entities. parallelFor() cuts the range
+//into chunks of grain items and deals them out evenly, one run of chunks per thread. Every thread
+//takes chunks from the front of its own run, and when that's empty it steals the back half of
+//someone else's. Taking and stealing are single compare-and-swaps, and the calling thread
+//works too.
+//
+//Which thread runs a chunk changes from run to run, so bodies that produce something should
+//write it to a slot for their chunk (begin / grain) and merge the slots in order afterwards.
+//That way the result doesn't depend on the thread count.
+class JobSystem {
+public:
+    //threads counts the caller, 1 runs everything inline. 0 means one per hardware thread.
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned threadCount() const { return unsigned(workers.size()) + 1; }
+
+    //Calls body(begin, end) for every chunk of [0, count) and returns once they're all done.
+    //Doesn't allocate, and isn't reentrant: bodies can't call parallelFor themselves.
+    template <typename Body>
+    void parallelFor(uint32_t count, uint32_t grain, Body&& body) {
+        run(count, grain, [](void* context, uint32_t begin, uint32_t end) {
+            (*static_cast<typename std::remove_reference<Body>::type*>(context))(begin, end);
+        }, &body);
+    }
+
+    static uint32_t chunkCount(uint32_t count, uint32_t grain) { return (count + grain - 1) / grain; }
+
+private:
+    typedef void (*RangeFunction)(void* context, uint32_t begin, uint32_t end);
+
+    //Chunks [begin, end) still to run, packed as begin << 32 | end so both ends move in one CAS
+    struct alignas(64) Queue {
+        std::atomic<uint64_t> range{ 0 };
+    };
+
+    void run(uint32_t count, uint32_t grain, RangeFunction function, void* context);
+    void workerLoop(unsigned index);
+    void work(unsigned index);
+    bool take(unsigned index, uint32_t& chunk);
+    bool steal(unsigned thief, uint32_t& chunk);
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues; //One per thread, 0 is the caller
+
+    //The job being run, written before generation is bumped
+    RangeFunction function = nullptr;
+    void* context = nullptr;
+    uint32_t count = 0, grain = 1;
+
+    std::atomic<uint64_t> generation{ 0 };
+    std::atomic<uint32_t> remaining{ 0 }; //Chunks not finished yet
+    std::atomic<uint32_t> finished{ 0 }; //Workers done with the current generation
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    bool quit = false;
+};
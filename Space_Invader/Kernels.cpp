@@ -0,0 +1,309 @@
+#include "Kernels.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//MSVC lets any function use any intrinsic, GCC and Clang need the target spelled out
+#if defined(KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+using namespace std;
+
+namespace {
+    const float LeftEdge = 40.f;
+    const float RightEdge = 640.f;
+    const float Bottom = 550.f;
+    const float StepSize = 5.f;
+    const float RowHeight = 50.f;
+
+    void clearMask(uint64_t* mask, uint32_t count) {
+        memset(mask, 0, maskWords(count) * sizeof(uint64_t));
+    }
+
+    void setBit(uint64_t* mask, uint32_t i) {
+        mask[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    //Scalar versions, also used for the leftover tail of the SIMD loops
+
+    void integrateBulletsFrom(const BulletArrays& b, uint32_t i, float deltaTime, float bottom, uint64_t* offscreen) {
+        for (; i < b.count; i++) {
+            float x = b.x[i], y = b.y[i];
+            b.previousX[i] = x;
+            b.previousY[i] = y;
+            if (y < 0.f || y > bottom)
+                setBit(offscreen, i);
+            b.x[i] = x + b.vx[i] * deltaTime;
+            b.y[i] = y + b.vy[i] * deltaTime;
+        }
+    }
+
+    void stepFormationFrom(const FormationArrays& e, uint32_t i, uint64_t* edgeHit, uint64_t* reachedBottom) {
+        for (; i < e.count; i++) {
+            float x = e.x[i], y = e.y[i];
+            float step = StepSize * float(e.direction[i]);
+            if (!e.movever[i]) {
+                if (x == RightEdge || x == LeftEdge) {
+                    e.y[i] = y + StepSize;
+                    e.direction[i] = -e.direction[i];
+                    e.movever[i] = 1;
+                    setBit(edgeHit, i);
+                }
+                else
+                    e.x[i] = x + step;
+            }
+            else {
+                float row = float(int(y / RowHeight));
+                if (y - row * RowHeight == 0.f) {
+                    e.x[i] = x + step;
+                    e.movever[i] = 0;
+                }
+                else {
+                    e.y[i] = y + StepSize;
+                    if (e.y[i] == Bottom)
+                        setBit(reachedBottom, i);
+                }
+            }
+            e.flip[i] ^= 1;
+        }
+    }
+
+    void integrateBulletsScalar(const BulletArrays& b, float deltaTime, float bottom, uint64_t* offscreen) {
+        clearMask(offscreen, b.count);
+        integrateBulletsFrom(b, 0, deltaTime, bottom, offscreen);
+    }
+
+    void stepFormationScalar(const FormationArrays& e, uint64_t* edgeHit, uint64_t* reachedBottom) {
+        clearMask(edgeHit, e.count);
+        clearMask(reachedBottom, e.count);
+        stepFormationFrom(e, 0, edgeHit, reachedBottom);
+    }
+
+    const KernelSet Scalar = { "scalar", integrateBulletsScalar, stepFormationScalar };
+
+#ifdef KERNELS_X86
+    //SSE2, four lanes
+
+    TARGET_SSE2 void integrateBulletsSSE2(const BulletArrays& b, float deltaTime, float bottom, uint64_t* offscreen) {
+        clearMask(offscreen, b.count);
+        const __m128 dt = _mm_set1_ps(deltaTime);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 limit = _mm_set1_ps(bottom);
+        uint32_t i = 0;
+        for (; i + 4 <= b.count; i += 4) {
+            __m128 x = _mm_loadu_ps(b.x + i);
+            __m128 y = _mm_loadu_ps(b.y + i);
+            _mm_storeu_ps(b.previousX + i, x);
+            _mm_storeu_ps(b.previousY + i, y);
+            __m128 out = _mm_or_ps(_mm_cmplt_ps(y, zero), _mm_cmpgt_ps(y, limit));
+            offscreen[i >> 6] |= uint64_t(_mm_movemask_ps(out)) << (i & 63);
+            _mm_storeu_ps(b.x + i, _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(b.vx + i), dt)));
+            _mm_storeu_ps(b.y + i, _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(b.vy + i), dt)));
+        }
+        integrateBulletsFrom(b, i, deltaTime, bottom, offscreen);
+    }
+
+    TARGET_SSE2 void stepFormationSSE2(const FormationArrays& e, uint64_t* edgeHit, uint64_t* reachedBottom) {
+        clearMask(edgeHit, e.count);
+        clearMask(reachedBottom, e.count);
+        const __m128 left = _mm_set1_ps(LeftEdge), right = _mm_set1_ps(RightEdge), bottom = _mm_set1_ps(Bottom);
+        const __m128 stepSize = _mm_set1_ps(StepSize), rowHeight = _mm_set1_ps(RowHeight), zero = _mm_setzero_ps();
+        const __m128i one = _mm_set1_epi32(1);
+        uint32_t i = 0;
+        for (; i + 4 <= e.count; i += 4) {
+            __m128 x = _mm_loadu_ps(e.x + i);
+            __m128 y = _mm_loadu_ps(e.y + i);
+            __m128i direction = _mm_loadu_si128((const __m128i*)(e.direction + i));
+            __m128i moveverBits = _mm_loadu_si128((const __m128i*)(e.movever + i));
+            __m128 movever = _mm_castsi128_ps(_mm_cmpeq_epi32(moveverBits, one));
+
+            __m128 edge = _mm_or_ps(_mm_cmpeq_ps(x, right), _mm_cmpeq_ps(x, left));
+            __m128 row = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(y, rowHeight)));
+            __m128 aligned = _mm_cmpeq_ps(_mm_sub_ps(y, _mm_mul_ps(row, rowHeight)), zero);
+
+            //Sideways when walking and not at an edge, or when a drop lines up with a row
+            __m128 sideways = _mm_or_ps(_mm_andnot_ps(movever, _mm_andnot_ps(edge, _mm_castsi128_ps(_mm_set1_epi32(-1)))), _mm_and_ps(movever, aligned));
+            __m128 turn = _mm_andnot_ps(movever, edge);
+
+            __m128 step = _mm_mul_ps(stepSize, _mm_cvtepi32_ps(direction));
+            __m128 newX = _mm_add_ps(x, _mm_and_ps(sideways, step));
+            __m128 newY = _mm_add_ps(y, _mm_andnot_ps(sideways, stepSize));
+            _mm_storeu_ps(e.x + i, newX);
+            _mm_storeu_ps(e.y + i, newY);
+
+            //Negate direction where the enemy turned: (d ^ -1) - (-1) == -d
+            __m128i turnBits = _mm_castps_si128(turn);
+            direction = _mm_sub_epi32(_mm_xor_si128(direction, turnBits), turnBits);
+            _mm_storeu_si128((__m128i*)(e.direction + i), direction);
+            _mm_storeu_si128((__m128i*)(e.movever + i), _mm_andnot_si128(_mm_castps_si128(sideways), one));
+            __m128i flip = _mm_loadu_si128((const __m128i*)(e.flip + i));
+            _mm_storeu_si128((__m128i*)(e.flip + i), _mm_xor_si128(flip, one));
+
+            __m128 landed = _mm_and_ps(_mm_andnot_ps(aligned, movever), _mm_cmpeq_ps(newY, bottom));
+            edgeHit[i >> 6] |= uint64_t(_mm_movemask_ps(turn)) << (i & 63);
+            reachedBottom[i >> 6] |= uint64_t(_mm_movemask_ps(landed)) << (i & 63);
+        }
+        stepFormationFrom(e, i, edgeHit, reachedBottom);
+    }
+
+    //AVX2, eight lanes
+
+    TARGET_AVX2 void integrateBulletsAVX2(const BulletArrays& b, float deltaTime, float bottom, uint64_t* offscreen) {
+        clearMask(offscreen, b.count);
+        const __m256 dt = _mm256_set1_ps(deltaTime);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 limit = _mm256_set1_ps(bottom);
+        uint32_t i = 0;
+        for (; i + 8 <= b.count; i += 8) {
+            __m256 x = _mm256_loadu_ps(b.x + i);
+            __m256 y = _mm256_loadu_ps(b.y + i);
+            _mm256_storeu_ps(b.previousX + i, x);
+            _mm256_storeu_ps(b.previousY + i, y);
+            __m256 out = _mm256_or_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), _mm256_cmp_ps(y, limit, _CMP_GT_OQ));
+            offscreen[i >> 6] |= uint64_t(_mm256_movemask_ps(out)) << (i & 63);
+            _mm256_storeu_ps(b.x + i, _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(b.vx + i), dt)));
+            _mm256_storeu_ps(b.y + i, _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(b.vy + i), dt)));
+        }
+        integrateBulletsFrom(b, i, deltaTime, bottom, offscreen);
+    }
+
+    TARGET_AVX2 void stepFormationAVX2(const FormationArrays& e, uint64_t* edgeHit, uint64_t* reachedBottom) {
+        clearMask(edgeHit, e.count);
+        clearMask(reachedBottom, e.count);
+        const __m256 left = _mm256_set1_ps(LeftEdge), right = _mm256_set1_ps(RightEdge), bottom = _mm256_set1_ps(Bottom);
+        const __m256 stepSize = _mm256_set1_ps(StepSize), rowHeight = _mm256_set1_ps(RowHeight), zero = _mm256_setzero_ps();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i allBits = _mm256_set1_epi32(-1);
+        uint32_t i = 0;
+        for (; i + 8 <= e.count; i += 8) {
+            __m256 x = _mm256_loadu_ps(e.x + i);
+            __m256 y = _mm256_loadu_ps(e.y + i);
+            __m256i direction = _mm256_loadu_si256((const __m256i*)(e.direction + i));
+            __m256i moveverBits = _mm256_loadu_si256((const __m256i*)(e.movever + i));
+            __m256 movever = _mm256_castsi256_ps(_mm256_cmpeq_epi32(moveverBits, one));
+
+            __m256 edge = _mm256_or_ps(_mm256_cmp_ps(x, right, _CMP_EQ_OQ), _mm256_cmp_ps(x, left, _CMP_EQ_OQ));
+            __m256 row = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_div_ps(y, rowHeight)));
+            __m256 aligned = _mm256_cmp_ps(_mm256_sub_ps(y, _mm256_mul_ps(row, rowHeight)), zero, _CMP_EQ_OQ);
+
+            __m256 sideways = _mm256_or_ps(_mm256_andnot_ps(movever, _mm256_andnot_ps(edge, _mm256_castsi256_ps(allBits))), _mm256_and_ps(movever, aligned));
+            __m256 turn = _mm256_andnot_ps(movever, edge);
+
+            __m256 step = _mm256_mul_ps(stepSize, _mm256_cvtepi32_ps(direction));
+            __m256 newX = _mm256_add_ps(x, _mm256_and_ps(sideways, step));
+            __m256 newY = _mm256_add_ps(y, _mm256_andnot_ps(sideways, stepSize));
+            _mm256_storeu_ps(e.x + i, newX);
+            _mm256_storeu_ps(e.y + i, newY);
+
+            __m256i turnBits = _mm256_castps_si256(turn);
+            direction = _mm256_sub_epi32(_mm256_xor_si256(direction, turnBits), turnBits);
+            _mm256_storeu_si256((__m256i*)(e.direction + i), direction);
+            _mm256_storeu_si256((__m256i*)(e.movever + i), _mm256_andnot_si256(_mm256_castps_si256(sideways), one));
+            __m256i flip = _mm256_loadu_si256((const __m256i*)(e.flip + i));
+            _mm256_storeu_si256((__m256i*)(e.flip + i), _mm256_xor_si256(flip, one));
+
+            __m256 landed = _mm256_and_ps(_mm256_andnot_ps(aligned, movever), _mm256_cmp_ps(newY, bottom, _CMP_EQ_OQ));
+            edgeHit[i >> 6] |= uint64_t(_mm256_movemask_ps(turn)) << (i & 63);
+            reachedBottom[i >> 6] |= uint64_t(_mm256_movemask_ps(landed)) << (i & 63);
+        }
+        stepFormationFrom(e, i, edgeHit, reachedBottom);
+    }
+
+    const KernelSet SSE2 = { "sse2", integrateBulletsSSE2, stepFormationSSE2 };
+    const KernelSet AVX2 = { "avx2", integrateBulletsAVX2, stepFormationAVX2 };
+
+    bool cpuHasSSE2() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true; //Part of x86-64 itself, only 32 bit x86 has to ask
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5));
+#else
+        return false;
+#endif
+    }
+#endif
+}
+
+const KernelSet& scalarKernels() {
+    return Scalar;
+}
+
+const KernelSet* sse2Kernels() {
+#ifdef KERNELS_X86
+    static const bool supported = cpuHasSSE2();
+    return supported ? &SSE2 : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const KernelSet* avx2Kernels() {
+#ifdef KERNELS_X86
+    static const bool supported = cpuHasAVX2();
+    return supported ? &AVX2 : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const KernelSet& activeKernels() {
+    static const KernelSet& chosen = []() -> const KernelSet& {
+        string name;
+#ifdef _MSC_VER
+        char* forced = nullptr;
+        size_t length = 0;
+        if (_dupenv_s(&forced, &length, "SPACE_INVADER_KERNELS") == 0 && forced) {
+            name = forced;
+            free(forced);
+        }
+#else
+        if (const char* forced = getenv("SPACE_INVADER_KERNELS"))
+            name = forced;
+#endif
+        if (name == "scalar")
+            return scalarKernels();
+        if (name != "sse2" && avx2Kernels())
+            return *avx2Kernels();
+        if (sse2Kernels())
+            return *sse2Kernels();
+        return scalarKernels();
+    }();
+    return chosen;
+}
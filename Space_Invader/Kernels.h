@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Batched movement for the hot per-tick loops. Each kernel walks the SoA arrays from
+//EntityStore in one pass and reports what it found as bitmasks (bit i set = slot i),
+//so the caller only does scalar work for the handful of entities that need it.
+//
+//Every variant does the same float operations in the same order (no FMA), so the
+//scalar, SSE2 and AVX2 versions give bit-identical results and replays stay in sync
+//across machines.
+
+struct BulletArrays {
+    float* x;
+    float* y;
+    const float* vx;
+    const float* vy;
+    float* previousX;
+    float* previousY;
+    uint32_t count;
+};
+
+struct FormationArrays {
+    float* x;
+    float* y;
+    int32_t* direction;
+    int32_t* movever;
+    int32_t* flip;
+    uint32_t count;
+};
+
+//Number of 64 bit words a mask needs for count slots
+inline uint32_t maskWords(uint32_t count) {
+    return (count + 63) / 64;
+}
+
+//Index of the lowest set bit, bits must not be zero
+inline uint32_t lowestBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, uint32_t(bits)))
+        return index;
+    _BitScanForward(&index, uint32_t(bits >> 32));
+    return index + 32;
+#else
+    return uint32_t(__builtin_ctzll(bits));
+#endif
+}
+
+struct KernelSet {
+    const char* name;
+
+    //Saves the previous position, flags bullets above or below the playfield (checked
+    //before moving, like the old Bullet::update) and moves everything by velocity * deltaTime.
+    void (*integrateBullets)(const BulletArrays& bullets, float deltaTime, float bottom, uint64_t* offscreen);
+
+    //One formation step: enemies walk sideways 5px, drop 5px at the 40/640 edges and
+    //keep dropping until they line up with the 50px rows again. edgeHit gets the
+    //enemies that turned around, reachedBottom the ones that landed on y = 550.
+    void (*stepFormation)(const FormationArrays& enemies, uint64_t* edgeHit, uint64_t* reachedBottom);
+};
+
+const KernelSet& scalarKernels();
+//These return nullptr when the CPU (or the build target) doesn't have the instructions
+const KernelSet* sse2Kernels();
+const KernelSet* avx2Kernels();
+
+//Best set this CPU supports, picked on first use. The SPACE_INVADER_KERNELS environment
+//variable (scalar, sse2 or avx2) overrides it for testing.
+const KernelSet& activeKernels();
@@ -0,0 +1,286 @@
+#include "LevelSet.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+    //Same as Resources/Levels/levels.txt
+    const char* DefaultLevelText = R"(
+archetype C skin=1 color=cyan    health=2 fire=spread   speed=320
+archetype G skin=1 color=green   health=1 fire=straight speed=480
+archetype M skin=1 color=magenta health=2 fire=diagonal speed=320
+archetype H skin=2 color=green   health=1 fire=straight speed=480
+archetype N skin=3 color=magenta health=2 fire=diagonal speed=320
+
+level 1
+wave origin=100,100 spacing=50,50
+MMMMMMMMMMM
+GGGGGGGGGGG
+GGGGGGGGGGG
+GGGGGGGGGGG
+GGGGGGGGGGG
+end
+
+level 2
+wave origin=100,100 spacing=50,50
+CCCCCCCCCCC
+HHHHHHHHHHH
+HHHHHHHHHHH
+HHHHHHHHHHH
+NNNNNNNNNNN
+end
+
+level 3
+wave origin=100,100 spacing=50,50
+MGCGCGCGCGM
+MGCGCGCGCGM
+MGCGCGCGCGM
+MGCGCGCGCGM
+MGCGCGCGCGM
+end
+
+level 4
+wave origin=100,100 spacing=50,50
+CCCCCCCCCCC
+HHHHHHHHHHH
+HHHHHHHHHHH
+NNNNNNNNNNN
+NNNNNNNNNNN
+end
+)";
+
+    bool parseColor(const string& value, uint32_t& color) {
+        static const pair<const char*, uint32_t> names[] = {
+            { "white", 0xFFFFFFFF }, { "red", 0xFF0000FF }, { "green", 0x00FF00FF }, { "blue", 0x0000FFFF },
+            { "yellow", 0xFFFF00FF }, { "magenta", 0xFF00FFFF }, { "cyan", 0x00FFFFFF }
+        };
+        for (const auto& name : names) {
+            if (value == name.first) {
+                color = name.second;
+                return true;
+            }
+        }
+        if (value.size() == 10 && value.compare(0, 2, "0x") == 0) {
+            char* end;
+            color = uint32_t(strtoul(value.c_str() + 2, &end, 16));
+            return *end == '\0';
+        }
+        return false;
+    }
+
+    bool parseFire(const string& value, FirePattern& fire) {
+        if (value == "none")
+            fire = FirePattern::None;
+        else if (value == "spread")
+            fire = FirePattern::Spread;
+        else if (value == "straight")
+            fire = FirePattern::Straight;
+        else if (value == "diagonal")
+            fire = FirePattern::Diagonal;
+        else
+            return false;
+        return true;
+    }
+
+    //"x,y"
+    bool parseVec(const string& value, Vec2& out) {
+        char* end;
+        out.x = strtof(value.c_str(), &end);
+        if (*end != ',')
+            return false;
+        out.y = strtof(end + 1, &end);
+        return *end == '\0';
+    }
+
+    bool parseInt(const string& value, int& out) {
+        char* end;
+        long parsed = strtol(value.c_str(), &end, 10);
+        out = int(parsed);
+        return !value.empty() && *end == '\0';
+    }
+
+    //Splits "key=value"
+    bool splitField(const string& field, string& key, string& value) {
+        size_t equals = field.find('=');
+        if (equals == string::npos)
+            return false;
+        key = field.substr(0, equals);
+        value = field.substr(equals + 1);
+        return true;
+    }
+}
+
+int LevelDefinition::enemyCount() const {
+    int count = 0;
+    for (const auto& wave : waves)
+        count += int(wave.spawns.size());
+    return count;
+}
+
+const LevelDefinition* LevelSet::find(int number) const {
+    for (const auto& level : levels) {
+        if (level.number == number)
+            return &level;
+    }
+    return nullptr;
+}
+
+int LevelSet::lastLevel() const {
+    return levels.empty() ? 0 : levels.back().number;
+}
+
+bool LevelSet::parse(const string& text, string& error) {
+    LevelSet result;
+    istringstream lines(text);
+    string line;
+    int lineNumber = 0;
+
+    LevelDefinition* level = nullptr;
+    bool inWave = false;
+    Vec2 origin = { 0.f, 0.f }, spacing = { 50.f, 50.f };
+    int row = 0;
+
+    auto fail = [&](const string& message) {
+        error = "line " + to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (getline(lines, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != string::npos)
+            line.erase(comment);
+        istringstream words(line);
+        string keyword;
+        if (!(words >> keyword))
+            continue;
+
+        //Inside a wave every line is a row of symbols until "end"
+        if (inWave) {
+            if (keyword == "end") {
+                inWave = false;
+                continue;
+            }
+            string extra;
+            if (words >> extra)
+                return fail("a wave row can't contain spaces");
+            for (size_t column = 0; column < keyword.size(); column++) {
+                if (keyword[column] == '.')
+                    continue;
+                auto found = find_if(result.archetypes.begin(), result.archetypes.end(), [&](const EnemyArchetype& archetype) {
+                    return archetype.symbol == keyword[column];
+                });
+                if (found == result.archetypes.end())
+                    return fail(string("no archetype uses the symbol ") + keyword[column]);
+                Spawn spawn;
+                spawn.position = { origin.x + column * spacing.x, origin.y + row * spacing.y };
+                spawn.direction = row % 2 == 0 ? 1 : -1;
+                spawn.archetype = uint16_t(found - result.archetypes.begin());
+                level->waves.back().spawns.push_back(spawn);
+            }
+            row++;
+            continue;
+        }
+
+        string field, key, value;
+        if (keyword == "archetype") {
+            EnemyArchetype archetype = { 0, 1, 0xFFFFFFFF, 1, FirePattern::None, 320.f, 0.01f };
+            string symbol;
+            if (!(words >> symbol) || symbol.size() != 1 || symbol == ".")
+                return fail("archetype needs a one character symbol");
+            archetype.symbol = symbol[0];
+            while (words >> field) {
+                if (!splitField(field, key, value))
+                    return fail("expected key=value, got " + field);
+                bool ok = true;
+                if (key == "skin")
+                    ok = parseInt(value, archetype.skin) && archetype.skin >= 1 && archetype.skin <= 3;
+                else if (key == "color")
+                    ok = parseColor(value, archetype.color);
+                else if (key == "health")
+                    ok = parseInt(value, archetype.health) && archetype.health > 0;
+                else if (key == "fire")
+                    ok = parseFire(value, archetype.fire);
+                else if (key == "speed")
+                    ok = !value.empty() && (archetype.bulletSpeed = strtof(value.c_str(), nullptr)) > 0.f;
+                else if (key == "rate")
+                    ok = !value.empty() && (archetype.fireRate = strtof(value.c_str(), nullptr)) >= 0.f;
+                else
+                    return fail("unknown archetype field " + key);
+                if (!ok)
+                    return fail("bad value for " + key + ": " + value);
+            }
+            for (const auto& existing : result.archetypes) {
+                if (existing.symbol == archetype.symbol)
+                    return fail(string("symbol ") + archetype.symbol + " is already used");
+            }
+            result.archetypes.push_back(archetype);
+        }
+        else if (keyword == "level") {
+            int number;
+            if (!(words >> value) || !parseInt(value, number) || number < 1)
+                return fail("level needs a number");
+            if (result.find(number))
+                return fail("level " + value + " is defined twice");
+            result.levels.push_back({ number, {} });
+            level = &result.levels.back();
+        }
+        else if (keyword == "wave") {
+            if (!level)
+                return fail("wave before any level");
+            origin = { 100.f, 100.f };
+            spacing = { 50.f, 50.f };
+            while (words >> field) {
+                if (!splitField(field, key, value))
+                    return fail("expected key=value, got " + field);
+                if (key == "origin" && parseVec(value, origin))
+                    continue;
+                if (key == "spacing" && parseVec(value, spacing))
+                    continue;
+                return fail("bad wave field " + field);
+            }
+            level->waves.push_back(Wave());
+            inWave = true;
+            row = 0;
+        }
+        else
+            return fail("unknown keyword " + keyword);
+    }
+    if (inWave)
+        return fail("wave is missing its end");
+
+    for (const auto& definition : result.levels) {
+        if (definition.enemyCount() == 0)
+            return fail("level " + to_string(definition.number) + " has no enemies");
+    }
+    sort(result.levels.begin(), result.levels.end(), [](const LevelDefinition& a, const LevelDefinition& b) {
+        return a.number < b.number;
+    });
+    *this = move(result);
+    return true;
+}
+
+bool LevelSet::load(const string& path, string& error) {
+    ifstream file(path);
+    if (!file) {
+        error = "couldn't open " + path;
+        return false;
+    }
+    stringstream text;
+    text << file.rdbuf();
+    return parse(text.str(), error);
+}
+
+shared_ptr<const LevelSet> defaultLevels() {
+    static shared_ptr<const LevelSet> levels = []() {
+        auto parsed = make_shared<LevelSet>();
+        string error;
+        parsed->parse(DefaultLevelText, error);
+        return parsed;
+    }();
+    return levels;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Geometry.h"
+
+//Levels are described in a small text format (Resources/Levels/levels.txt) and turned into
+//plain spawn lists once at load time, so spawning a wave is just a loop over an array.
+//
+//    # comment
+//    archetype <symbol> skin=1 color=magenta health=2 fire=diagonal speed=320 rate=0.01
+//    level <number>
+//    wave origin=100,100 spacing=50,50
+//    MMMMMMMMMMM        one line per row, one archetype symbol per column, '.' leaves a gap
+//    GGGGGGGGGGG        rows alternate direction, the first one heads right
+//    end
+//
+//A level can have any number of waves, each one spawns when the previous one is wiped out.
+//Colours are a name (white red green blue yellow magenta cyan) or 0xRRGGBBAA.
+//Fire patterns: spread (three shots), straight (one fast shot), diagonal (two angled shots).
+//rate is shots per second for each enemy of that archetype, 0.01 when left out.
+
+//Matches the enemy id the simulation and the sounds already use
+enum class FirePattern : uint8_t { None = 0, Spread = 1, Straight = 2, Diagonal = 3 };
+
+struct EnemyArchetype {
+    char symbol;
+    int skin; //Which texture pair, 1 to 3
+    uint32_t color;
+    int health;
+    FirePattern fire;
+    float bulletSpeed;
+    float fireRate; //Shots per second
+};
+
+struct Spawn {
+    Vec2 position;
+    int direction;
+    uint16_t archetype; //Index into LevelSet::archetypes
+};
+
+struct Wave {
+    std::vector<Spawn> spawns;
+};
+
+struct LevelDefinition {
+    int number;
+    std::vector<Wave> waves;
+
+    int enemyCount() const;
+};
+
+struct LevelSet {
+    std::vector<EnemyArchetype> archetypes;
+    std::vector<LevelDefinition> levels; //Sorted by number
+
+    const LevelDefinition* find(int number) const;
+    int lastLevel() const; //Highest level number, 0 when empty
+
+    //Replaces the contents. On failure error says which line was wrong and the set is left alone.
+    bool parse(const std::string& text, std::string& error);
+    bool load(const std::string& path, std::string& error);
+};
+
+//The four original formations, built in so the simulation works without any files
+std::shared_ptr<const LevelSet> defaultLevels();
@@ -1,808 +1,747 @@
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <random>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <thread>
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
+#include "AllocationCounter.h"
+#include "Animation.h"
+#include "AssetArchive.h"
+#include "AssetLoader.h"
+#include "BatchText.h"
+#include "GameSimulation.h"
+#include "Input.h"
+#include "JobSystem.h"
+#include "Netplay.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "Replay.h"
+#include "ResourceCache.h"
+#include "SimulationThread.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "UdpTransport.h"
+#include "VoicePool.h"
+
 using namespace std;
 using namespace sf;
 
-struct Bullet {
-    Sprite sprite;
-    Vector2f velocity;
-    bool Active;
-    bool PlayerOrigin;
-
-    Bullet(Vector2f position, Vector2f velocity, const Texture& texture, bool PlayerOrigin, const Color& color = Color::White)
-        : velocity(velocity), Active(true), PlayerOrigin(PlayerOrigin) {
-        sprite.setTexture(texture);
-        sprite.setPosition(position + Vector2f(17.f, 0.f));
-        sprite.setColor(color);
-    }
-
-    void update(float deltaTime) {
-        if (sprite.getPosition().y < 0 || sprite.getPosition().y > 720)
-            Active = false;
-        if (Active) {
-            sprite.move(velocity * deltaTime);
-        }
-    }
-};
-
-struct Enemy {
-    Sprite sprite;
-    Vector2f velocity;
-    bool Active, movever;
-    int direction, id, flip, health, updating;
-
-    Enemy(Vector2f position, Vector2f velocity, const Texture& texture, int direction, int id, Color color, const int& health = 1)
-        : velocity(velocity), Active(true), direction(direction), movever(false), id(id), flip(1), health(health), updating(0) {
-        sprite.setTexture(texture);
-        sprite.setPosition(position);
-        sprite.setColor(color);
-    }
-
-    void update(float deltaTime) {
-        if (Active) {
-            sprite.move(velocity * deltaTime);
-        }
-    }
-
-    FloatRect getHitbox() const {
-        FloatRect originalBounds = sprite.getGlobalBounds();
-        
-        //Making the hitbox smaller
-        float xOffset = 13.0f;
-        float yOffset = 19.0f;
-
-        return FloatRect(
-            originalBounds.left + xOffset,
-            originalBounds.top + yOffset,
-            originalBounds.width - 2 * xOffset,
-            originalBounds.height - 2 * yOffset
-        );
+//Rendering side timing, the gameplay constants live in GameSimulation.h
+const float MaxFrameTime = 0.25f; //Keeps animations from jumping ahead after a stall
+const float BlinkTime = 0.1f;
+const float CreditsScrollSpeed = 16.f;
+const Color PartnerTint(120, 200, 255);
+const string ArchivePath = "Resources.pak";
+const string ManifestPath = "Resources/assets.txt";
+const string FontPath = "Resources/PressStart2P-Regular.ttf";
+const string LevelsPath = "Resources/Levels/levels.txt";
+
+Vector2f toVector(Vec2 v) {
+    return Vector2f(v.x, v.y);
+}
+
+//Where an entity should be drawn between its last two simulated positions
+Vector2f interpolate(Vec2 previous, Vec2 current, float alpha) {
+    return Vector2f(previous.x + (current.x - previous.x) * alpha, previous.y + (current.y - previous.y) * alpha);
+}
+
+//Thin bar along the bottom of the screen while assets are still loading
+struct LoadingBar : public Drawable {
+    RectangleShape outline, fill;
+
+    LoadingBar()
+        : outline(Vector2f(520.f, 16.f)), fill(Vector2f(0.f, 12.f)) {
+        outline.setPosition(Vector2f(100.f, 680.f));
+        outline.setFillColor(Color::Transparent);
+        outline.setOutlineColor(Color::White);
+        outline.setOutlineThickness(2.f);
+        fill.setPosition(Vector2f(102.f, 682.f));
+        fill.setFillColor(Color::White);
     }
-
-    void updateTexture(const Texture& newTexture) {
-        sprite.setTexture(newTexture);
+    void update(float progress) {
+        fill.setSize(Vector2f(516.f * progress, 12.f));
     }
-
-    void updateColor(const Color& color = Color::White) {
-        sprite.setColor(color);
-    }
-};
-
-struct TextDisplay {
-    Text text;
-    Font font;
-
-    TextDisplay(const string& content, int characterSize, Vector2f position)
-        : text(content, font), font() {
-        font.loadFromFile("Resources/PressStart2P-Regular.ttf");
-
-        text.setFont(font);
-        text.setCharacterSize(characterSize);
-        text.setFillColor(Color::White);
-        text.setPosition(position);
-    }
-    void draw(RenderWindow& window) {
-        window.draw(text);
-    }
-    void update(const string& newtext) {
-        text.setString(newtext);
-    }
-};
-
-struct Animation {
-    Sprite sprite;
-    Vector2u frameSize;
-    int Maxframes;
-    int frame, updatetimer, speed;
-    bool Active, loop;
-
-    Animation(Vector2f position, const Texture& texture, Vector2u frameSize, int updatetimer, const bool& loop = false)
-        : Maxframes(texture.getSize().x / frameSize.x), frameSize(frameSize), frame(0), updatetimer(updatetimer), Active(true), loop(loop) {
-        speed = updatetimer;
-        sprite.setTexture(texture);
-        sprite.setTextureRect(IntRect(0, 0, frameSize.x, frameSize.y));
-        sprite.setPosition(position);
-    }
-
-    void update() {
-        if (speed == 0) {
-            frame = (frame + 1) % Maxframes;
-            sprite.setTextureRect(IntRect(frameSize.x * frame, 0, frameSize.x, frameSize.y));
-            if (frame >= Maxframes - 1 && !loop)
-                Active = false;
-            speed = updatetimer;
-        }
-        else
-            speed--;
-    }
-};
-
-struct Audio {
-    Sound sound;
-    bool loop;
-
-    Audio(SoundBuffer& SoundBuffer, const bool& loop = false)
-        : loop(loop) {
-        sound.setBuffer(SoundBuffer);
-        sound.play();
-        sound.setLoop(loop);
+    void draw(RenderTarget& target, RenderStates states) const override {
+        target.draw(outline, states);
+        target.draw(fill, states);
     }
 };
 
+//The visual side of the ship. Its position, direction and animation frame all come from the
+//simulation, which tests hits against the frame it says is on screen.
 struct Player
 {
-    Animation* animation;
-    Vector2f velocity;
-    int direction;
-    Player(Vector2f position, const Texture& texture, Vector2u(frameSize))
-        : velocity(0.f, 0.f), direction(0) {
-        animation = new Animation(position, texture, frameSize, 90, true);
-        animation->sprite.setPosition(position);
+    const AnimationClip* clips[3]; //Indexed by direction: straight, turning left, turning right
+    Player(const AnimationClip& straight, const AnimationClip& left, const AnimationClip& right)
+        : clips{ &straight, &left, &right } {
     }
 
-    void setAnimation(Animation* NewAnimation) {
-        delete animation;
-        animation = NewAnimation;
-    }
-
-    void move(float deltaTime) {
-        animation->sprite.move(velocity * deltaTime);
-    }
-
-    void update() {
-        animation->update();
-    }
-
-    //No modified hitbox for the player because they don't deserve any mercy >:)
-    void draw(RenderWindow& window) {
-        window.draw(animation->sprite);
-    }
-
-    ~Player() {
-        delete animation;
+    void draw(SpriteBatch& batch, int direction, int frame, Vector2f position, Color color = Color::White) {
+        batch.draw(clips[direction]->frames[frame], position, color);
     }
 };
 
-int main()
+int main(int argc, char* argv[])
 {
     const int Width = 720;
     const int Height = 720;
-    bool game_over = 0;
     //chrono::microseconds time(0);
 
-    SoundBuffer Fire1;
-    Fire1.loadFromFile("Resources/Sounds/Fire 1.wav");
-    SoundBuffer Fire3;
-    Fire3.loadFromFile("Resources/Sounds/Fire 3.wav");
-    SoundBuffer Fire4;
-    Fire4.loadFromFile("Resources/Sounds/Fire 4 multi.wav");
-    SoundBuffer Fire5;
-    Fire5.loadFromFile("Resources/Sounds/Fire 5.wav");
-    SoundBuffer PlayerDeath;
-    PlayerDeath.loadFromFile("Resources/Sounds/Player Death.wav");
-    SoundBuffer EnemyDeath;
-    EnemyDeath.loadFromFile("Resources/Sounds/Enemy Death.wav");
-    SoundBuffer MenuPing;
-    MenuPing.loadFromFile("Resources/Sounds/Menu.wav");
+    //Every asset is read out of this one mapped file. It's declared first so it outlives the
+    //fonts and music that keep reading from it. Without the file (nothing ran PackAssets, like
+    //the Visual Studio build) the same assets come from the loose files in Resources/.
+    AssetArchive archive;
+    string archiveError;
+    if (!archive.open(ArchivePath, archiveError)) {
+        cout << ArchivePath << " not loaded (" << archiveError << "), reading the files in Resources/ instead\n";
+        if (!archive.openLoose(ManifestPath, archiveError)) {
+            cout << "Can't load the game's assets: " << archiveError << "\n";
+            return 1;
+        }
+    }
+
+    //Fonts and sound buffers are loaded once and shared, "--stats" prints what the cache holds
+    Clock startupClock;
+    Resources resources(archive);
+    bool printStats = false;
+    for (int i = 1; i < argc; i++)
+        printStats = printStats || string(argv[i]) == "--stats";
+
     Music Corneria;
-    Corneria.openFromFile("Resources/Sounds/Star Fox Restored - Corneria.wav");
     Music Lost;
-    Lost.openFromFile("Resources/Sounds/Lost.wav");
     Music Win;
-    Win.openFromFile("Resources/Sounds/Star Fox - OST - Arrange Version Main Theme.wav");
-
     Event event;
 
-    mt19937_64 randomizer(chrono::system_clock::now().time_since_epoch().count());
-
     RenderWindow window(VideoMode(Width, Height), "Space Invaders", Style::Titlebar);
     window.setView(View(FloatRect(0, 0, Width, Height)));
 
-    Texture Player_texture;
-    Player_texture.loadFromFile("Resources/Images/player_animation.png");
-
-    Texture Player_texture_left;
-    Player_texture_left.loadFromFile("Resources/Images/Player_Turning_Animation_Left.png");
-
-    Texture Player_texture_right;
-    Player_texture_right.loadFromFile("Resources/Images/Player_Turning_Animation_Right.png");
-
-    Texture lives_texture;
-    lives_texture.loadFromFile("Resources/Images/Lives.png");
-    Sprite lives_display(lives_texture);
-
-    Texture Credits_texture;
-    Credits_texture.loadFromFile("Resources/Images/Credits.png");
-    Sprite Credits;
-    Credits.setTexture(Credits_texture);
-    Credits.setPosition(Vector2f(110.f, 400.f));
-
-    Player player(Vector2f(375.f, 550.f), Player_texture, Vector2u(50, 34));
-
-    TextDisplay pressExit("Press Enter To Exit!", 30, Vector2f(10.f, 90.f));
-    TextDisplay GAMEOVER("GAME OVER!", 50, Vector2f(10.f, 10.f));
-    TextDisplay YOUWIN("YOU WIN!", 50, Vector2f(10.f, 10.f)); //fml
-    TextDisplay Menu_Start("Start Game", 30, Vector2f(200.f, 150.f));
-    TextDisplay Menu_Exit("Exit Game", 30, Vector2f(200.f, 200.f));
-    TextDisplay Menu_LevelSelect("Level Select", 30, Vector2f(200.f, 250.f));
-    TextDisplay Menu_Credit("Credits", 30, Vector2f(200.f, 300.f));
-
-    Texture Explosion_Texture;
-    Explosion_Texture.loadFromFile("Resources/Images/Explosion.png");
-
-    Texture Explosion_Texture_small;
-    Explosion_Texture_small.loadFromFile("Resources/Images/Explosion_small.png");
-
-    Texture background_texture;
-    background_texture.loadFromFile("Resources/Images/Background.png");
-    Sprite background_sprite;
-    background_sprite.setTexture(background_texture);
-    background_sprite.setPosition(0.f, 0.f);
-
-    Texture PlayerBullet;
-    PlayerBullet.loadFromFile("Resources/Images/PlayerBullet.png");
-
-    Texture EnemyBullet;
-    EnemyBullet.loadFromFile("Resources/Images/EnemyBullet.png");
-
-    Texture enemyBullet1;
-    enemyBullet1.loadFromFile("Resources/Images/PlayerBullet.png");
-
-    vector<Enemy> enemies;
-
-    Texture MenuChoice;
-    MenuChoice.loadFromFile("Resources/Images/Menu_Choice.png");
-    Sprite MenuChoicesprite;
-    MenuChoicesprite.setTexture(MenuChoice);
-    MenuChoicesprite.setPosition(Vector2f(175.f, 187.f));
+    //Vsync by default, "--fps N" swaps it for a frame limiter (0 means uncapped)
+    //"--record file" saves every run to a replay, "--replay file" plays one back instead of the menu
+    //"--host PORT" or "--join ADDRESS:PORT" plays co-op over the network instead of the menu,
+    //"--delay N" and "--rollback N" tune it (in ticks, see Netplay.h)
+    //"--pad N" picks which gamepad plays, the first one by default
+    bool vsync = true;
+    int pad = 0;
+    unsigned frameLimit = 0;
+    string recordPath, replayPath;
+    int netPlayer = -1; //0 hosting, 1 joining
+    string joinAddress;
+    unsigned short netPort = 0;
+    NetSettings netSettings;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--no-vsync")
+            vsync = false;
+        else if (arg == "--fps" && i + 1 < argc) {
+            vsync = false;
+            frameLimit = unsigned(max(0, atoi(argv[++i])));
+        }
+        else if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--host" && i + 1 < argc) {
+            netPlayer = 0;
+            netPort = (unsigned short)atoi(argv[++i]);
+        }
+        else if (arg == "--join" && i + 1 < argc) {
+            string target = argv[++i];
+            size_t colon = target.rfind(':');
+            netPlayer = 1;
+            joinAddress = target.substr(0, colon);
+            netPort = colon == string::npos ? 0 : (unsigned short)atoi(target.c_str() + colon + 1);
+        }
+        else if (arg == "--delay" && i + 1 < argc)
+            netSettings.inputDelay = atoi(argv[++i]);
+        else if (arg == "--rollback" && i + 1 < argc)
+            netSettings.rollbackWindow = atoi(argv[++i]);
+        else if (arg == "--pad" && i + 1 < argc)
+            pad = max(0, atoi(argv[++i]));
+    }
+    UdpTransport transport;
+    if (netPlayer == 0 && !transport.host(netPort))
+        return 1;
+    if (netPlayer == 1 && (netPort == 0 || !transport.join(joinAddress, netPort))) {
+        cout << "--join needs ADDRESS:PORT\n";
+        return 1;
+    }
+    NetSession session(transport, max(netPlayer, 0), netSettings);
+    bool netplay = netPlayer >= 0, waitingForPartner = netplay, partnerGone = false;
+    window.setVerticalSyncEnabled(vsync);
+    //Input does its own key repeat, the OS one would turn a held key into a stream of presses
+    window.setKeyRepeatEnabled(false);
+    window.setFramerateLimit(frameLimit);
+
+    //Every image goes into one atlas texture so the game draws in a single batch
+    TextureAtlas atlas;
+    SpriteBatch batch(atlas.texture);
+    const char* atlasImages[] = {
+        "Background", "Credits", "Enemy1", "Enemy1_1", "Enemy2", "Enemy2_1", "Enemy3", "Enemy3_1", "EnemyBullet", "Explosion",
+        "Explosion_small", "Font", "Lives", "Menu_Choice", "Player", "Player2", "PlayerBullet", "Player_Turning_Animation_Left",
+        "Player_Turning_Animation_Right", "player_animation"
+    };
 
-    Texture enemyTexture1;
-    enemyTexture1.loadFromFile("Resources/Images/Enemy1.png");
+    //Everything is decoded on worker threads, menu assets first. The menu comes up as soon as
+    //its own assets are in and the rest keeps loading behind it.
+    AssetLoader loader(archive);
+    loader.addFont(FontPath, AssetGroup::Menu);
+    for (const char* name : atlasImages)
+        loader.addImage(name, string("Resources/Images/") + name + ".png", AssetGroup::Menu);
+    loader.addSound("Resources/Sounds/Menu.wav", AssetGroup::Menu);
+    //The Star Fox tracks aren't shipped, the game runs without them
+    loader.addMusic(Corneria, "Resources/Sounds/Star Fox Restored - Corneria.wav", AssetGroup::Menu, true);
+    loader.addSound("Resources/Sounds/Fire 3.wav", AssetGroup::Game);
+    loader.addSound("Resources/Sounds/Fire 4 multi.wav", AssetGroup::Game);
+    loader.addSound("Resources/Sounds/Fire 5.wav", AssetGroup::Game);
+    loader.addSound("Resources/Sounds/Player Death.wav", AssetGroup::Game);
+    loader.addSound("Resources/Sounds/Enemy Death.wav", AssetGroup::Game);
+    loader.addMusic(Lost, "Resources/Sounds/Lost.wav", AssetGroup::Game);
+    loader.addMusic(Win, "Resources/Sounds/Star Fox - OST - Arrange Version Main Theme.wav", AssetGroup::Game, true);
+    //Text is drawn from glyphs in the atlas too, at the three sizes the game uses
+    GlyphAtlas glyphs;
+    loader.addGlyphs(glyphs, FontPath, { 24, 30, 50 });
+    if (!loader.start())
+        return 1;
+
+    LoadingBar loadingBar;
+    while (window.isOpen() && !loader.ready(AssetGroup::Menu)) {
+        while (window.pollEvent(event)) {
+            if (event.type == Event::Closed)
+                window.close();
+        }
+        loader.poll(resources, atlas);
+        loadingBar.update(loader.progress());
+        window.clear();
+        window.draw(loadingBar);
+        window.display();
+    }
 
-    Texture enemyTexture2;
-    enemyTexture2.loadFromFile("Resources/Images/Enemy2.png");
+    //Effects are (buffer, priority, how many can play at once). The gameplay ones get their
+    //buffers once the Game group has finished loading.
+    VoicePool voices;
+    SoundEffect MenuPing = voices.addEffect(resources.sounds.get("Resources/Sounds/Menu.wav"), 2, 2);
+    SoundEffect Fire3 = voices.addEffect(nullptr, 1, 4);
+    SoundEffect Fire4 = voices.addEffect(nullptr, 1, 4);
+    SoundEffect Fire5 = voices.addEffect(nullptr, 1, 4);
+    SoundEffect EnemyDeath = voices.addEffect(nullptr, 2, 6);
+    SoundEffect PlayerDeath = voices.addEffect(nullptr, 3, 1);
+
+    //The Game group can finish while the menu is still loading or on any frame after that, so
+    //this is checked after both loops rather than only when a poll() finishes it
+    bool gameAssetsBound = false;
+    auto bindGameAssets = [&]() {
+        if (gameAssetsBound || !loader.done())
+            return;
+        gameAssetsBound = true;
+        voices.setBuffer(Fire3, resources.sounds.get("Resources/Sounds/Fire 3.wav"));
+        voices.setBuffer(Fire4, resources.sounds.get("Resources/Sounds/Fire 4 multi.wav"));
+        voices.setBuffer(Fire5, resources.sounds.get("Resources/Sounds/Fire 5.wav"));
+        voices.setBuffer(PlayerDeath, resources.sounds.get("Resources/Sounds/Player Death.wav"));
+        voices.setBuffer(EnemyDeath, resources.sounds.get("Resources/Sounds/Enemy Death.wav"));
+        if (printStats) {
+            cout << "Everything loaded after " << startupClock.getElapsedTime().asMilliseconds() << " ms\n";
+            loader.printTimings(cout);
+            resources.printStats(cout);
+        }
+    };
 
-    Texture enemyTexture3;
-    enemyTexture3.loadFromFile("Resources/Images/Enemy3.png");
+    //Every animation is a clip over atlas rects, made once here and shared by whatever plays it
+    const AnimationClip PlayerClip = AnimationClip::strip(atlas.region("player_animation"), Vector2i(50, 34), ShipFrameTime, LoopMode::Loop);
+    const AnimationClip PlayerLeftClip = AnimationClip::strip(atlas.region("Player_Turning_Animation_Left"), Vector2i(42, 34), ShipFrameTime, LoopMode::Loop);
+    const AnimationClip PlayerRightClip = AnimationClip::strip(atlas.region("Player_Turning_Animation_Right"), Vector2i(42, 34), ShipFrameTime, LoopMode::Loop);
+    const AnimationClip ExplosionClip = AnimationClip::strip(atlas.region("Explosion"), Vector2i(50, 50), 0.03f, LoopMode::Once);
+    const AnimationClip SmallExplosionClip = AnimationClip::strip(atlas.region("Explosion_small"), Vector2i(25, 25), 0.03f, LoopMode::Once);
+    IntRect lives_texture = atlas.region("Lives");
+    IntRect lives_display = lives_texture;
+    IntRect Credits_texture = atlas.region("Credits");
+    Vector2f Credits(110.f, 400.f);
+
+    Player player(PlayerClip, PlayerLeftClip, PlayerRightClip);
+    Player partner(PlayerClip, PlayerLeftClip, PlayerRightClip);
+
+    TextRun pressExit(glyphs, 30, "Press Enter To Exit!", Vector2f(10.f, 90.f));
+    TextRun GAMEOVER(glyphs, 50, "GAME OVER!", Vector2f(10.f, 10.f));
+    TextRun YOUWIN(glyphs, 50, "YOU WIN!", Vector2f(10.f, 10.f)); //fml
+    TextRun Menu_Start(glyphs, 30, "Start Game", Vector2f(200.f, 150.f));
+    TextRun Menu_Exit(glyphs, 30, "Exit Game", Vector2f(200.f, 200.f));
+    TextRun Menu_LevelSelect(glyphs, 30, "Level Select", Vector2f(200.f, 250.f));
+    TextRun Menu_Credit(glyphs, 30, "Credits", Vector2f(200.f, 300.f));
+    TextRun Waiting(glyphs, 30, netPlayer == 1 ? "Joining game..." : "Waiting for player 2", Vector2f(10.f, 330.f));
+
+    IntRect background_texture = atlas.region("Background");
+    IntRect PlayerBullet = atlas.region("PlayerBullet");
+    IntRect EnemyBullet = atlas.region("EnemyBullet");
+    IntRect MenuChoice = atlas.region("Menu_Choice");
+
+    //Enemies have two frames and swap them every formation step, so the frame comes from the
+    //simulation's flip flag rather than a clock. Indexed by skin - 1.
+    AnimationClip enemyClips[3];
+    for (int skin = 0; skin < 3; skin++) {
+        string name = "Enemy" + to_string(skin + 1);
+        enemyClips[skin].frames = { atlas.region(name + "_1"), atlas.region(name) };
+        enemyClips[skin].durations = { EnemyStepTime, EnemyStepTime };
+        enemyClips[skin].loop = LoopMode::Loop;
+    }
 
-    Texture enemyTexture1_1;
-    enemyTexture1_1.loadFromFile("Resources/Images/Enemy1_1.png");
+    int game_start = 1, menu_choice = 1, level_select = 0, credits = 0;
+
+    //The game itself, seeded here so a run can be reproduced from the seed alone
+    uint64_t seed = chrono::system_clock::now().time_since_epoch().count();
+    GameSimulation sim(seed);
+
+    //Collision and bullet movement get split over the cores the simulation and render threads leave free
+    //hardware_concurrency() is 0 when it can't tell
+    unsigned hw = thread::hardware_concurrency();
+    JobSystem jobs(hw > 1 ? hw - 1 : 1);
+    sim.jobs = &jobs;
+
+    //During a run the simulation ticks on its own thread and the loop below only draws its snapshots,
+    //so the next tick is simulated while this one is on screen. sim is only touched here while it's stopped.
+    SimulationThread simulation(sim);
+
+    //Level layouts come from the level file, F5 reloads it and the next level uses the new one.
+    //The built in copy is used if the file is missing or broken.
+    shared_ptr<const LevelSet> levelSet = defaultLevels();
+    auto loadLevels = [&]() {
+        Clock parseClock;
+        auto loaded = make_shared<LevelSet>();
+        string error;
+        if (!loaded->load(LevelsPath, error)) {
+            cout << "Couldn't load " << LevelsPath << " (" << error << "), keeping the current levels\n";
+            return;
+        }
+        levelSet = loaded;
+        simulation.setLevels(levelSet);
+        cout << "Loaded " << loaded->levels.size() << " levels in " << parseClock.getElapsedTime().asMicroseconds() << " us\n";
+    };
+    loadLevels();
+
+    //Either recording what gets played or feeding a loaded replay into the simulation
+    Replay replay;
+    bool recording = false, replaying = false;
+    size_t replayTick = 0;
+    if (!replayPath.empty() && !netplay) {
+        replaying = replay.load(replayPath);
+        if (!replaying)
+            cout << "Couldn't read the replay " << replayPath << "\n";
+    }
+    //Keyboard and gamepad, read from the events below. Presses are seen the frame they happen
+    //and the next tick picks them up, so the menus never block the loop.
+    Input input(pad);
+
+    //Replays are read and recorded on the simulation thread, one input per tick
+    const SoundEffect GameEffects[] = { Fire3, Fire4, Fire5, EnemyDeath, PlayerDeath };
+    auto startSimulation = [&]() {
+        //Runs wait for the Game group, so by now every gameplay effect should have its buffer
+        bindGameAssets();
+        for (SoundEffect effect : GameEffects) {
+            if (!voices.hasBuffer(effect))
+                cout << "Sound effect " << effect << " has no buffer, it will stay silent\n";
+        }
+        //Up and A shoot as well as move the menu, those presses shouldn't fire the run's first shot
+        input.clearTaps();
+        simulation.start([&](const InputFrame& live) {
+            InputFrame frame = live;
+            if (replaying)
+                frame = replay.input(replayTick++);
+            if (recording)
+                replay.record(frame);
+            return frame;
+        }, [&](const GameSimulation& stepped) {
+            //Replay::finish() takes the checksum after the last step, so it's compared here too
+            if (replaying && replayTick == replay.ticks() && stepped.tick == replay.ticks()) {
+                bool synced = replay.finalChecksum == 0 || replay.finalChecksum == stepped.checksum();
+                cout << "Replay finished " << (synced ? "in sync" : "OUT OF SYNC") << "\n";
+            }
+        });
+    };
+    auto startRun = [&](int level, float introTime) {
+        sim.start(level, introTime);
+        if (!recordPath.empty()) {
+            replay.begin(seed, level, introTime);
+            recording = true;
+        }
+        startSimulation();
+    };
+    auto saveRecording = [&]() {
+        simulation.stop();
+        if (!recording)
+            return;
+        recording = false;
+        replay.finish(sim);
+        if (replay.save(recordPath))
+            cout << "Saved " << replay.ticks() << " ticks to " << recordPath << "\n";
+        else
+            cout << "Couldn't write the replay " << recordPath << "\n";
+    };
 
-    Texture enemyTexture2_1;
-    enemyTexture2_1.loadFromFile("Resources/Images/Enemy2_1.png");
+    //Explosions come from a fixed pool, if it ever runs out the extra ones just aren't shown
+    Pool<Animation> animations(64);
+
+    TextRun Lives(glyphs, 24, "Lives: ", Vector2f(10.f, 620.f));
+    TextRun Level(glyphs, 50, "Level: ", Vector2f(10.f, 10.f));
+    NumberField levelNumber(glyphs, 50, Vector2f(10.f + Level.width(), 10.f), sim.level);
+    TextRun Levels[5] = {
+        {glyphs, 30, "Level 1", Vector2f(200.f ,150.f)},
+        {glyphs, 30, "Level 2", Vector2f(200.f ,200.f)},
+        {glyphs, 30, "Level 3", Vector2f(200.f ,250.f)},
+        {glyphs, 30, "Level 4", Vector2f(200.f ,300.f)},
+        {glyphs, 30, "Level inf", Vector2f(200.f ,350.f)}
+    };
 
-    Texture enemyTexture3_1;
-    enemyTexture3_1.loadFromFile("Resources/Images/Enemy3_1.png");
+    //The labels never change, only the numbers after them get redone
+    TextRun Score_Display(glyphs, 24, "Score: ", Vector2f(10.f, 10.f));
+    NumberField scoreNumber(glyphs, 24, Vector2f(10.f + Score_Display.width(), 10.f), sim.global_score);
 
-    int Reloading = 0, enemymoving = 0, global_score = 0, score = 0, lives = 3, respawn = 0, game_win = 0, game_start = 1, menu_choice = 1, invulnarablity = 0, invtimer = 0, level = 1, starting = 0, level_set = 1, level_select = 0, infinite = 0, enemyRandom = 1, difficulty = 1, credits = 0, credits_timer = 0;
-    Color EnemyColor = Color::White;
+    //A Music that was never opened has no channels, playing it would only print errors
+    if (Corneria.getChannelCount() > 0) {
+        Corneria.play();
+        Corneria.setLoop(true);
+    }
 
-    vector<Bullet> bullets;
-    vector<Animation> animations;
-    vector<Audio> sounds;
-    Vector2f temp_position;
+    if (printStats)
+        cout << "Menu ready after " << startupClock.getElapsedTime().asMilliseconds() << " ms\n";
+    bindGameAssets();
 
-    TextDisplay Lives("Lives: ", 24, Vector2f(10.f, 620.f));
-    lives_display.setPosition(Vector2f(150.f, 618.f));
-    TextDisplay Level("Level: " + to_string(level), 50, Vector2f(10.f, 10.f));
-    TextDisplay Levels[5] = {
-        {"Level 1", 30, Vector2f(200.f ,150.f)},
-        {"Level 2", 30, Vector2f(200.f ,200.f)},
-        {"Level 3", 30, Vector2f(200.f ,250.f)},
-        {"Level 4", 30, Vector2f(200.f ,300.f)},
-        {"Level inf", 30, Vector2f(200.f ,350.f)}
-    };
+    Clock frameClock;
 
-    TextDisplay Score_Display("Score: " + to_string(score), 24, Vector2f(10.f, 10.f));
+    //With "--stats" the average draw calls per frame get printed once a second
+    Clock statsClock;
+    unsigned statsFrames = 0, statsDrawCalls = 0, statsQuads = 0;
+    uint64_t statsAllocations = allocationCount();
 
-    //Setting frame control and frame duration for 60 FPS
-    //Clock Main_clock;
-    //Time Game_frameDuration = seconds(1.0f / 60.0f);
-    
-    Corneria.play();
-    Corneria.setLoop(true);
+    //F3 shows the profiler overlay, F4 starts and stops a trace capture written to trace.json, F5 reloads the levels
+    Profiler profiler;
+    simulation.setProfiler(&profiler);
+    ProfilerOverlay overlay(resources.fonts.get(FontPath));
+    OverlayCounts counts;
 
-    bernoulli_distribution FireChance(0.00001);
-    bernoulli_distribution EnemySpawnChance(0.000001);
-    uniform_int_distribution<int> EnemyType(1, 3);
-    uniform_int_distribution<int> EnemyRandomizer(1, 7);
+    int shownScore = 0;
 
     while (window.isOpen()) {
+        profiler.beginFrame();
+        uint64_t phaseBegin = profiler.now();
+
         //Process events
         while (window.pollEvent(event)) {
+            input.handleEvent(event);
             if (event.type == Event::Closed) {
                 window.close();
             }
-        }
-        //Time elapsed = Main_clock.restart();
-
-        if (!game_over && !game_win && !game_start && starting == 0) {
-            player.velocity.x = 0.f;
-            temp_position = player.animation->sprite.getPosition();
-
-            if (level_set) {
-                switch (level) {
-                case 1 :
-                    for (int i = 0; i < 5; i++) {
-                        for (int j = 0, tempdirection; j < 11; j++) {
-                            Vector2f position = Vector2f(100.0f, 100.0f) + Vector2f(j * 50.0f, i * 50.0f);
-                            if (i % 2 == 0) {
-                                tempdirection = 1;
-                            }
-                            else {
-                                tempdirection = -1;
-                            }
-                            if (i == 0)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 3, Color::Magenta, 2);
-                            else
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 2, Color::Green);
-                        }
-                    }
-                    break;
-                case 2 :
-                    for (int i = 0; i < 5; i++) {
-                        for (int j = 0, tempdirection; j < 11; j++) {
-                            Vector2f position = Vector2f(100.0f, 100.0f) + Vector2f(j * 50.0f, i * 50.0f);
-                            if (i % 2 == 0) {
-                                tempdirection = 1;
-                            }
-                            else {
-                                tempdirection = -1;
-                            }
-                            if (i == 0)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 1, Color::Cyan, 2);
-                            else if (i < 4)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture2, tempdirection, 2, Color::Green);
-                            else
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture3, tempdirection, 3, Color::Magenta, 2);
-                        }
-                    }
-                    break;
-                case 3:
-                    for (int i = 0; i < 5; i++) {
-                        for (int j = 0, tempdirection; j < 11; j++) {
-                            Vector2f position = Vector2f(100.0f, 100.0f) + Vector2f(j * 50.0f, i * 50.0f);
-                            if (i % 2 == 0) {
-                                tempdirection = 1;
-                            }
-                            else {
-                                tempdirection = -1;
-                            }
-                            if (j == 0 || j == 10)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 3, Color::Magenta, 2);
-                            else if (j % 2 == 0)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 1, Color::Cyan, 2);
-                            else
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 2, Color::Green);
-                        }
-                    }
-                    break;
-                case 4:
-                    for (int i = 0; i < 5; i++) {
-                        for (int j = 0, tempdirection; j < 11; j++) {
-                            Vector2f position = Vector2f(100.0f, 100.0f) + Vector2f(j * 50.0f, i * 50.0f);
-                            if (i % 2 == 0) {
-                                tempdirection = 1;
-                            }
-                            else {
-                                tempdirection = -1;
-                            }
-                            if (i == 0)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture1, tempdirection, 1, Color::Cyan, 2);
-                            else if (i == 1 || i == 2)
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture2, tempdirection, 2, Color::Green);
-                            else
-                                enemies.emplace_back(position, Vector2f(0.0f, 0.0f), enemyTexture3, tempdirection, 3, Color::Magenta, 2);
-                        }
-                    }
-                    break;
-                case 5 :
-                    infinite = 1;
-                    break;
-                default:
-                    break;
-                }
-                
-                starting = 1000;
-                player.animation->sprite.setPosition(375.f, 550.f);
-                level_set = 0;
-            }
-
-            // broken, don't run
-            if (infinite) {
-                enemyRandom = EnemyRandomizer(randomizer);
-                switch (difficulty / 100) {
-                case 0 :
-                    EnemyColor = Color::Green;
-                    break;
-                case 1 :
-                    EnemyColor = Color::Cyan;
-                    break;
-                case 2:
-                    EnemyColor = Color::Magenta;
-                    break;
-                case 3:
-                    EnemyColor = Color::Blue;
-                    break;
-                case 4:
-                    EnemyColor = Color::White;
-                    break;
-                case 5:
-                    EnemyColor = Color::Yellow;
-                    break;
-                case 6:
-                    EnemyColor = Color::Red;
-                    break;
-                default:
-                    break;
-                }
-                if (EnemySpawnChance(randomizer) || enemies.empty()) {
-                    switch (EnemyType(randomizer)) {
-                    case 1:
-                        enemies.emplace_back(Vector2f(100.f, 100.f), Vector2f(0.0f, 0.0f), enemyTexture1, 1, 1, EnemyColor, enemyRandom);
-                        break;
-                    case 2:
-                        enemies.emplace_back(Vector2f(100.f, 100.f), Vector2f(0.0f, 0.0f), enemyTexture1, 1, 2, EnemyColor, enemyRandom);
-                        break;
-                    case 3:
-                        enemies.emplace_back(Vector2f(100.f, 100.f), Vector2f(0.0f, 0.0f), enemyTexture1, 1, 3, EnemyColor, enemyRandom);
-                        break;
-                    default:
-                        cout << "Failed at randomizing enemy type";
-                        break;
-                    }
-                }
-                difficulty = min(975, 40 * score / 2);
-            }
-            if (Keyboard::isKeyPressed(Keyboard::Escape)) {
-                for (auto& animation : animations)
-                    animation.Active = false;
-                for (auto& enemy : enemies)
-                    enemy.Active = false;
-                for (auto& bullet : bullets)
-                    bullet.Active = false;
-                Reloading = 0, enemymoving = 0, global_score = 0, score = 0, lives = 3, respawn = 0, game_start = 1, menu_choice = 1, invulnarablity = 0, invtimer = 0, level = 1, starting = 0, level_set = 1, level_select = 0, infinite = 0, enemyRandom = 1, difficulty = 1;
-            }
-            if (Keyboard::isKeyPressed(Keyboard::Left) && player.animation->sprite.getPosition().x > 40) {
-                player.velocity.x = -20.f;
-                if (player.direction != 1) {
-                    player.setAnimation(new Animation(temp_position, Player_texture_left, Vector2u(42, 34), 90, true));
-                    player.direction = 1;
-                }
-            }
-            else if (Keyboard::isKeyPressed(Keyboard::Right) && player.animation->sprite.getPosition().x < 640) {
-                player.velocity.x = 20.f;
-                if (player.direction != 2) {
-                    player.setAnimation(new Animation(temp_position, Player_texture_right, Vector2u(42, 34), 90, true));
-                    player.direction = 2;
+            if (event.type == Event::KeyPressed && event.key.code == Keyboard::F3)
+                overlay.visible = !overlay.visible;
+            //Both machines have to play the same levels, co-op sticks to the built in ones
+            if (event.type == Event::KeyPressed && event.key.code == Keyboard::F5 && !netplay)
+                loadLevels();
+            if (event.type == Event::KeyPressed && event.key.code == Keyboard::F4) {
+                if (!profiler.capturing()) {
+                    profiler.startCapture();
+                    cout << "Trace capture started\n";
                 }
-            }
-            else {
-                if (player.direction != 0) {
-                    player.setAnimation(new Animation(temp_position, Player_texture, Vector2u(50, 34), 90, true));
-                    player.direction = 0;
+                else {
+                    profiler.stopCapture();
+                    cout << (profiler.writeTrace("trace.json") ? "Trace written to trace.json\n" : "Couldn't write trace.json\n");
                 }
             }
+        }
 
-            if (Reloading == 0) {
-                if (Keyboard::isKeyPressed(Keyboard::Up) || Keyboard::isKeyPressed(Keyboard::Z)) {
-                    //Create a new bullet and add it to the vector
-                    bullets.emplace_back(player.animation->sprite.getPosition(), Vector2f(0.f, -30.f), PlayerBullet, true, Color::Green);
-                    Reloading = 1000; //Very dumb implementation but it's 3 am it'll have to do
-                }
-            }
-            else
-                Reloading--;
-            player.move(0.016f);  //Adjust for fps?
-
-            if (respawn != 0) {
-                respawn--;
-                if (respawn == 0)
-                    player.animation->sprite.setPosition(375.f, 550.f);
+        if (!loader.done()) {
+            loader.poll(resources, atlas);
+            loadingBar.update(loader.progress());
+        }
+        bindGameAssets();
+        float frameTime = min(frameClock.restart().asSeconds(), MaxFrameTime);
+        input.update(frameTime);
+        profiler.record("input", phaseBegin, profiler.now());
+        phaseBegin = profiler.now();
+
+        //Co-op starts as soon as the other side is there. The host picks the seed and the level,
+        //runs aren't recorded.
+        if (waitingForPartner && loader.ready(AssetGroup::Game)) {
+            int level = 1;
+            if (session.handshake(seed, level)) {
+                waitingForPartner = false;
+                sim = GameSimulation(seed);
+                sim.coop = true;
+                sim.setLevels(defaultLevels());
+                sim.jobs = &jobs;
+                sim.start(level, GameStartIntroTime);
+                session.begin(sim);
+                simulation.setSession(&session);
+                game_start = 0;
+                startSimulation();
             }
+        }
 
-            //Omg enemy shooting who tf gave them a gun O_o
-            for (auto& enemy : enemies) {
-                enemy.update(0.016f);
-                if (enemy.updating > 0) {
-                    enemy.updating--;
-                    if (enemy.updating == 0) {
-                        if (enemy.id == 1)
-                            enemy.updateColor(Color::Cyan);
-                        if (enemy.id == 2)
-                            enemy.updateColor(Color::Green);
-                        if (enemy.id == 3)
-                            enemy.updateColor(Color::Magenta);
-                    }  
-                }
-                
-                if (FireChance(randomizer)) {
-                    if (enemy.id == 1) {
-                        bullets.emplace_back(enemy.sprite.getPosition() + Vector2f(-15.0f, 0.f), Vector2f(0.f, 20.f), EnemyBullet, false);
-                        bullets.emplace_back(enemy.sprite.getPosition() + Vector2f(0.f, 20.f), Vector2f(0.f, 20.f), EnemyBullet, false);
-                        bullets.emplace_back(enemy.sprite.getPosition() + Vector2f(15.0f, 0.f), Vector2f(0.f, 20.f), EnemyBullet, false);
-                        sounds.emplace_back(Fire4);
-                    }
-                    if (enemy.id == 2) {
-                        bullets.emplace_back(enemy.sprite.getPosition(), Vector2f(0.f, 30.f), EnemyBullet, false, Color::Yellow);
-                        sounds.emplace_back(Fire5);
-                    }
-                    if (enemy.id == 3) {
-                        bullets.emplace_back(enemy.sprite.getPosition(), Vector2f(2.f, 20.f), PlayerBullet, false, Color::Red);
-                        bullets.emplace_back(enemy.sprite.getPosition(), Vector2f(-2.f, 20.f), PlayerBullet, false, Color::Red);
-                        sounds.emplace_back(Fire3);
-                    }
-                }
-            }
+        //The session ended the run when the other side left, the game over screen takes it from here
+        if (netplay && !partnerGone && session.partnerLeft()) {
+            partnerGone = true;
+            cout << "The other side left the game\n";
+        }
 
-            for (auto& animation : animations) {
-                animation.update();
-            }
+        if (replaying && game_start && loader.ready(AssetGroup::Game)) {
+            replay.restart(sim);
+            sim.setLevels(levelSet);
+            sim.jobs = &jobs;
+            replayTick = 0;
+            game_start = 0;
+            startSimulation();
+        }
 
-            if (enemymoving == 0) {
-                for (auto& enemy : enemies) {
-                    if (enemy.movever == false) {
-                        if ((enemy.sprite.getPosition().x == 640 || enemy.sprite.getPosition().x == 40)) {
-                            enemy.sprite.setPosition(enemy.sprite.getPosition() + Vector2f(0.0f, 5.0f));
-                            enemy.direction *= -1;
-                            enemy.movever = true;
-                        }
-                        else
-                            enemy.sprite.setPosition(enemy.sprite.getPosition() + Vector2f(5.0f * enemy.direction, 0.0f));
-                    }
-                    else if (enemy.movever == true) {
-                        if (int(enemy.sprite.getPosition().y) % 50 == 0) {
-                            enemy.sprite.setPosition(enemy.sprite.getPosition() + Vector2f(5.0f * enemy.direction, 0.0f));
-                            enemy.movever = false;
-                        }
-                        else {
-                            enemy.sprite.setPosition(enemy.sprite.getPosition() + Vector2f(0.0f, 5.0f));
-                            if (enemy.sprite.getPosition().y == 550.f)
-                                game_over = 1;
-                        }
-                    }
-                    if (enemy.id == 1) {
-                        if (enemy.flip)
-                            enemy.updateTexture(enemyTexture1_1);
-                        else
-                            enemy.updateTexture(enemyTexture1);
-                        enemy.flip = !enemy.flip;
-                    }
-                    else if (enemy.id == 2) {
-                        if (enemy.flip)
-                            enemy.updateTexture(enemyTexture2_1);
-                        else
-                            enemy.updateTexture(enemyTexture2);
-                        enemy.flip = !enemy.flip;
-                    }
-                    else {
-                        if (enemy.flip)
-                            enemy.updateTexture(enemyTexture3_1);
-                        else
-                            enemy.updateTexture(enemyTexture3);
-                        enemy.flip = !enemy.flip;
-                    }
-                }
-                enemymoving = 1000 - difficulty; //Reset the last move time
+        if (!game_start)
+            simulation.setInput(input.tickInput());
+        const Snapshot& view = simulation.latest();
+
+        //Sounds and effects for every tick finished since the last frame
+        GameEvent e;
+        while (simulation.popEvent(e)) {
+            switch (e.type) {
+            case GameEvent::EnemyFired:
+                if (e.id == 1)
+                    voices.play(Fire4);
+                if (e.id == 2)
+                    voices.play(Fire5);
+                if (e.id == 3)
+                    voices.play(Fire3);
+                break;
+            case GameEvent::EnemyKilled:
+                animations.acquire(Animation(SmallExplosionClip, toVector(e.position) + Vector2f(13.f, 13.f)));
+                voices.play(EnemyDeath);
+                break;
+            case GameEvent::PlayerHit:
+                if (e.id == 0)
+                    animations.acquire(Animation(ExplosionClip, toVector(e.position) + Vector2f(0.f, -12.f)));
+                else
+                    animations.acquire(Animation(ExplosionClip, toVector(e.position) + Vector2f(8.f, -12.f)));
+                voices.play(PlayerDeath);
+                break;
+            case GameEvent::LevelStarted:
+                levelNumber.set(e.id);
+                break;
+            default:
+                break;
             }
-            else
-                enemymoving--;
-
-            for (auto& bullet : bullets) {
-                bullet.update(0.016f);
-                for (auto& enemy : enemies) {
-                    if (bullet.sprite.getGlobalBounds().intersects(enemy.getHitbox()) && bullet.PlayerOrigin == true) {
-                        //Collision detected, remove the bullet and reduce health
-                        bullet.Active = false;
-                        enemy.health--;
-                        if (enemy.health == 0) {
-                            enemy.Active = false;
-                            animations.emplace_back(enemy.sprite.getPosition() + Vector2f(13.f, 13.f), Explosion_Texture_small, Vector2u(25, 25), 30);
-                            sounds.emplace_back(EnemyDeath);
-                            global_score++;
-                            score++;
-                            Score_Display.update("Score: " + to_string(global_score));
-                            if (score == 55) {
-                                if (level != 4) {
-                                    level++;
-                                    Level.update("Level: " + to_string(level));
-                                    level_set = 1;
-                                    score = 0;
-                                }
-                                else
-                                    game_win = 1;
-                            }
-                            if (!infinite)
-                                difficulty = min(975, 40 * score / 2);
-                        }
-                        else {
-                            enemy.updateColor();
-                            enemy.updating = 50;
-                        }
-                    }
-                }
-                if (bullet.sprite.getGlobalBounds().intersects(player.animation->sprite.getGlobalBounds()) && bullet.PlayerOrigin == false) {
-                    if (invulnarablity == 0) {
-                        lives--;
-                        bullet.Active = false;
-                        if (player.direction == 0)
-                            animations.emplace_back(player.animation->sprite.getPosition() + Vector2f(0.f, -12.f), Explosion_Texture, Vector2u(50, 50), 30);
-                        else
-                            animations.emplace_back(player.animation->sprite.getPosition() + Vector2f(8.f, -12.f), Explosion_Texture, Vector2u(50, 50), 30);
-                        sounds.emplace_back(PlayerDeath);
-                        invulnarablity = 300;
-                        player.animation->sprite.setPosition(375.f, -100.f);
-                        respawn = 1000;
-                        if (lives == 0)
-                            game_over = 1;
-                    }
-                }
+        }
+        if (view.score != shownScore) {
+            shownScore = view.score;
+            scoreNumber.set(shownScore);
+        }
+
+        if (!game_start && view.playing) {
+            advanceAll(animations, frameTime);
+
+            //Leaving a co-op game quits outright, the other side is told on the way out and ends its run
+            if (input.pressed(Action::Back) && !view.intro && netplay)
+                window.close();
+            else if (input.pressed(Action::Back) && !view.intro) {
+                saveRecording();
+                animations.clear();
+                replaying = false;
+                seed = chrono::system_clock::now().time_since_epoch().count();
+                sim = GameSimulation(seed);
+                sim.setLevels(levelSet);
+                sim.jobs = &jobs;
+                simulation.refresh();
+                game_start = 1, menu_choice = 1, level_select = 0;
             }
+        }
+        else if (!game_start && simulation.running())
+            saveRecording();
 
-            //Clear the window
-            window.clear();
+        profiler.record("events", phaseBegin, profiler.now());
+        phaseBegin = profiler.now();
 
+        //How far we are between the newest tick and the next one
+        uint64_t now = uint64_t(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+        float alpha = now > view.time ? min(float(now - view.time) / 1e9f / TickDuration, 1.f) : 0.f;
+
+        //Clear the window
+        window.clear();
+        batch.beginFrame();
+        batch.draw(background_texture, Vector2f(0.f, 0.f));
+
+        if (!game_start && view.playing && !view.intro) {
             //Draw
-            window.draw(background_sprite);
-            if (invulnarablity <= 0)
-                player.draw(window);
-            else {
-                if (invtimer == 0) {
-                    player.draw(window);
-                    invtimer = 10;
-                    invulnarablity--;
-                }
-                invtimer--;
-            }
+            //Blink while invulnerable
+            if (view.invulnerability <= 0.f || fmod(view.invulnerability, BlinkTime) < BlinkTime / 2)
+                player.draw(batch, view.playerDirection, view.playerFrame, interpolate(view.playerPrevious, view.playerPosition, alpha));
+            if (view.coop && (view.partnerInvulnerability <= 0.f || fmod(view.partnerInvulnerability, BlinkTime) < BlinkTime / 2))
+                partner.draw(batch, view.partnerDirection, view.partnerFrame, interpolate(view.partnerPrevious, view.partnerPosition, alpha), PartnerTint);
+
+            if (view.lives == 2)
+                lives_display = subRect(lives_texture, IntRect(0, 0, 100, 50));
+            if (view.lives == 1)
+                lives_display = subRect(lives_texture, IntRect(0, 0, 50, 50));
+            batch.draw(lives_display, Vector2f(150.f, 618.f));
 
-            Lives.draw(window);
-            Score_Display.draw(window);
-            if (lives == 2)
-                lives_display.setTextureRect(IntRect(0, 0, 100, 50));
-            if (lives == 1)
-                lives_display.setTextureRect(IntRect(0, 0, 50, 50));
-                
-            window.draw(lives_display);
             //Draw enemies
-            for (const auto& enemy : enemies) {
-                window.draw(enemy.sprite);
-            }
-            for (const auto& bullet : bullets) {
-                window.draw(bullet.sprite);
+            //Sprites only exist here, built from the snapshot
+            for (const auto& enemy : view.enemies) {
+                Color color = enemy.flash ? Color::White : Color(enemy.color);
+                batch.draw(enemyClips[enemy.skin - 1].frames[enemy.flip], Vector2f(enemy.x, enemy.y), color);
             }
-            for (const auto& animation : animations) {
-                window.draw(animation.sprite);
+            for (const auto& bullet : view.bullets) {
+                const IntRect& region = bullet.skin == BulletSkin::PlayerBullet ? PlayerBullet : EnemyBullet;
+                batch.draw(region, interpolate({ bullet.previousX, bullet.previousY }, { bullet.x, bullet.y }, alpha), Color(bullet.color));
             }
-            player.animation->update();
-            window.display();
+            animations.forEach([&](const Animation& animation, uint32_t) {
+                batch.draw(animation.frameRect(), animation.position);
+            });
+
+            //Glyphs come from the atlas as well, so text is just more quads in the same batch
+            Lives.draw(batch);
+            Score_Display.draw(batch);
+            scoreNumber.draw(batch);
         }
         else {
-            window.clear();
-
-            window.draw(background_sprite);
-
-            if (starting != 0) {
-                Level.draw(window);
-                starting--;
+            if (!game_start && view.intro) {
+                Level.draw(batch);
+                levelNumber.draw(batch);
             }
 
             if (level_select || credits) {
-                if (Keyboard::isKeyPressed(Keyboard::Escape)) {
-                    sounds.emplace_back(MenuPing);
+                if (input.pressed(Action::Back)) {
+                    voices.play(MenuPing);
                     level_select = 0;
                     credits = 0;
                     menu_choice = 1;
                 }
             }
 
-            if (Keyboard::isKeyPressed(Keyboard::Enter) && !credits && game_start) {
-                sounds.emplace_back(MenuPing);
+            if (input.pressed(Action::Confirm) && !credits && game_start && !netplay) {
+                voices.play(MenuPing);
+                //Levels can't start until their sounds are in
+                bool canStart = loader.ready(AssetGroup::Game);
                 if (!level_select) {
-                    if (menu_choice == 1) {
+                    if (menu_choice == 1 && canStart) {
                         game_start = 0;
-                        starting = 600;
+                        startRun(1, GameStartIntroTime);
                     }
                     else if (menu_choice == 2)
                         window.close();
                     else if (menu_choice == 3) {
                         menu_choice = 1;
                         level_select = 1;
-                        sleep(seconds(0.2f));
                     }
                     else if (menu_choice == 4)
                         credits = 1;
                 }
-                else {
-                    level = menu_choice;
-                    Level.update("Level: " + to_string(level));
+                else if (canStart) {
+                    levelNumber.set(menu_choice);
+                    startRun(menu_choice, 0.f);
                     game_start = 0;
                 }
             }
             //Draw
-            if (game_over) {
+            if (view.gameOver) {
                 if (Lost.getStatus() != Sound::Playing) {
                     Corneria.stop();
                     Lost.play();
                     Lost.setLoop(true);
                 }
-                GAMEOVER.draw(window);
-                pressExit.draw(window);
-                if (Keyboard::isKeyPressed(Keyboard::Enter)) {
+                GAMEOVER.draw(batch);
+                pressExit.draw(batch);
+                if (input.pressed(Action::Confirm))
                     window.close();
-                }
             }
-            if (game_win) {
-                if (Win.getStatus() != Sound::Playing) {
+            if (view.gameWin) {
+                if (Win.getChannelCount() > 0 && Win.getStatus() != Sound::Playing) {
                     Corneria.stop();
                     Win.play();
                     Win.setLoop(true);
                 }
-                YOUWIN.draw(window);
-                pressExit.draw(window);
-                if (Keyboard::isKeyPressed(Keyboard::Enter))
+                YOUWIN.draw(batch);
+                pressExit.draw(batch);
+                if (input.pressed(Action::Confirm))
                     window.close();
             }
             else if (game_start) {
-                if (!credits) {
-                    if (Keyboard::isKeyPressed(Keyboard::Down)) {
+                if (!credits && !waitingForPartner) {
+                    if (input.pressed(Action::Down)) {
                         if (menu_choice < 4 + level_select)
                             menu_choice++;
                         else
                             menu_choice = 1;
-                        sounds.emplace_back(MenuPing);
-                        sleep(seconds(0.2f));
+                        voices.play(MenuPing);
                     }
-                    if (Keyboard::isKeyPressed(Keyboard::Up)) {
+                    if (input.pressed(Action::Up)) {
                         if (menu_choice > 1)
                             menu_choice--;
                         else
                             menu_choice = 4;
-                        sounds.emplace_back(MenuPing);
-                        sleep(seconds(0.2f));
+                        voices.play(MenuPing);
                     }
-                    MenuChoicesprite.setPosition(Vector2f(175.f, 50.f * menu_choice + 87.f));
-                    window.draw(MenuChoicesprite);
+                    batch.draw(MenuChoice, Vector2f(175.f, 50.f * menu_choice + 87.f));
                 }
-                if (!level_select && !credits) {
-                    Menu_Start.draw(window);
-                    Menu_Exit.draw(window);
-                    Menu_Credit.draw(window);
-                    Menu_LevelSelect.draw(window);
+                if (!loader.done())
+                    batch.drawDirect(window, loadingBar);
+                if (waitingForPartner)
+                    Waiting.draw(batch);
+                else if (!level_select && !credits) {
+                    Menu_Start.draw(batch);
+                    Menu_Exit.draw(batch);
+                    Menu_Credit.draw(batch);
+                    Menu_LevelSelect.draw(batch);
                 }
                 else if (level_select) {
                     for (int i = 0; i < 5; i++)
-                        Levels[i].draw(window);
+                        Levels[i].draw(batch);
                 }
                 else if (credits) {
-                    if (credits_timer == 0)
-                        credits_timer = 100;
-                    else
-                        credits_timer--;
-                    Credits.move(Vector2f(0.f, -0.016f));
-                    window.draw(Credits);
+                    Credits.y -= CreditsScrollSpeed * frameTime;
+                    batch.draw(Credits_texture, Credits);
                 }
             }
-            window.display();
         }
-        /*
-        //FIX THIS FOR THE LOVE OF GOD
-        Time sleepTime = Game_frameDuration - elapsed;
-        if (operator>(sleepTime, Time::Zero)) {
-            sleep(sleepTime);
+        counts.enemies = unsigned(view.enemies.size());
+        counts.bullets = unsigned(view.bullets.size());
+        counts.tickMs = view.stepNanoseconds / 1e6f;
+        simulation.drainProfile();
+        counts.animations = animations.inUse();
+        counts.voices = voices.playing();
+        overlay.update(profiler, counts);
+        if (overlay.visible)
+            batch.drawDirect(window, overlay);
+        batch.flush(window);
+        counts.drawCalls = batch.drawCalls;
+        counts.quads = batch.quads;
+        profiler.record("draw", phaseBegin, profiler.now());
+
+        {
+            ProfileScope scope(&profiler, "display");
+            window.display();
         }
-        */
 
-        enemies.erase(remove_if(enemies.begin(), enemies.end(), [](const Enemy& enemy) { return !enemy.Active; }), enemies.end());
-        bullets.erase(remove_if(bullets.begin(), bullets.end(), [](const Bullet& bullet) { return !bullet.Active; }), bullets.end());
-        animations.erase(remove_if(animations.begin(), animations.end(), [](const Animation& animation) { return !animation.Active; }), animations.end());
-        sounds.erase(remove_if(sounds.begin(), sounds.end(), [](const Audio& sound) {return (sound.sound.getStatus() == Sound::Stopped); }), sounds.end());
+        statsFrames++;
+        statsDrawCalls += batch.drawCalls;
+        statsQuads += batch.quads;
+        if (printStats && statsClock.getElapsedTime() >= seconds(1.f)) {
+            cout << statsFrames << " fps, " << statsDrawCalls / statsFrames << " draw calls/frame, " << statsQuads / statsFrames << " quads/frame, "
+                << voices.playing() << " voices playing, " << voices.getStats().stolen << " stolen, " << voices.getStats().dropped << " dropped, "
+                << (allocationCount() - statsAllocations) / statsFrames << " allocations/frame\n";
+            statsFrames = statsDrawCalls = statsQuads = 0;
+            statsAllocations = allocationCount();
+            statsClock.restart();
+        }
+        profiler.endFrame();
+    }
+    saveRecording();
+    if (netplay && !waitingForPartner) {
+        if (!session.partnerLeft())
+            session.leave();
+        const NetStats& stats = session.stats();
+        cout << "Co-op: " << stats.ticks << " ticks, " << stats.rollbacks << " rollbacks (" << stats.resimulatedTicks << " ticks simulated again, longest "
+            << stats.longestRollback << "), " << stats.stalls << " ticks waited on the other side\n";
+        if (session.desynced())
+            cout << "The two games went out of sync at tick " << session.firstDesync() << "\n";
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,283 @@
+#include "Netplay.h"
+
+#include <algorithm>
+
+#include "Replay.h"
+
+using namespace std;
+
+namespace {
+    const uint8_t ProtocolVersion = 1;
+    const int MaxInputsPerPacket = 128;
+    const uint32_t NoChecksum = UINT32_MAX;
+
+    //First byte of every packet
+    enum PacketType : uint8_t {
+        Hello = 1, //Joining side, until it gets a Start: u8 version
+        Start = 2, //Host: u8 version, u64 seed, u8 level
+        Inputs = 3, //u32 ack, u32 first tick, u8 count, count input bytes, u32 checksum tick, u64 checksum
+        Quit = 4 //Either side, when it leaves
+    };
+
+    const int QuitRepeats = 5;
+
+    void writeBytes(vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    //Reads from a packet, any read past the end sets failed instead of going out of bounds
+    struct Reader {
+        const vector<uint8_t>& data;
+        size_t offset = 0;
+        bool failed = false;
+
+        uint64_t bytes(int count) {
+            if (offset + count > data.size()) {
+                failed = true;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < count; i++)
+                value |= uint64_t(data[offset++]) << (8 * i);
+            return value;
+        }
+    };
+}
+
+NetSession::NetSession(Transport& transport, int localPlayer, NetSettings settings)
+    : transport(transport), localPlayer(localPlayer), config(settings) {
+    config.inputDelay = min(max(config.inputDelay, 0), MaxInputDelay);
+    config.rollbackWindow = min(max(config.rollbackWindow, 1), MaxRollbackWindow);
+    packet.reserve(16 + MaxInputsPerPacket);
+}
+
+bool NetSession::handshake(uint64_t& sessionSeed, int& sessionLevel) {
+    if (localPlayer == 0) {
+        seed = sessionSeed;
+        level = sessionLevel;
+        receive();
+        return peerConnected;
+    }
+
+    packet.clear();
+    packet.push_back(Hello);
+    packet.push_back(ProtocolVersion);
+    transport.send(packet);
+    counters.packetsSent++;
+    while (transport.receive(packet)) {
+        counters.packetsReceived++;
+        Reader reader{ packet };
+        if (reader.bytes(1) != Start || reader.bytes(1) != ProtocolVersion)
+            continue;
+        uint64_t hostSeed = reader.bytes(8);
+        int hostLevel = int(reader.bytes(1));
+        if (reader.failed)
+            continue;
+        sessionSeed = seed = hostSeed;
+        sessionLevel = level = hostLevel;
+        peerConnected = true;
+    }
+    return peerConnected;
+}
+
+void NetSession::begin(GameSimulation& simulation) {
+    sim = &simulation;
+    //Built up front so saving a state during play only copies into memory that's already there
+    states.clear();
+    states.reserve(StateSlots);
+    for (int i = 0; i < StateSlots; i++) {
+        states.emplace_back(0);
+        sim->copyStateTo(states.back());
+    }
+    //Nobody has input for the first inputDelay ticks, they count as nothing pressed
+    fill(localInputs, localInputs + HistorySize, 0);
+    fill(remoteInputs, remoteInputs + HistorySize, 0);
+    current = 0;
+    localEnd = uint64_t(config.inputDelay);
+    remoteEnd = 0;
+    peerHas = 0;
+    rollbackTo = NoFrame;
+    peerLeft.store(false, memory_order_relaxed);
+    counters = NetStats();
+}
+
+uint8_t NetSession::remoteInput(uint64_t frame) const {
+    if (frame < remoteEnd)
+        return remoteInputs[frame % HistorySize];
+    //Not here yet, guess they're still pressing whatever they pressed last
+    return remoteEnd > 0 ? remoteInputs[(remoteEnd - 1) % HistorySize] : 0;
+}
+
+bool NetSession::advance(const InputFrame& local) {
+    receive();
+    if (rollbackTo != NoFrame)
+        rollback();
+    if (endIfLeft())
+        return false;
+
+    if (current >= remoteEnd + config.rollbackWindow) {
+        counters.stalls++;
+        sendInputs(); //Keeps our acks going out, the other side may be waiting on those
+        return false;
+    }
+
+    localInputs[localEnd % HistorySize] = packInput(local);
+    localEnd++;
+    sendInputs();
+
+    simulate(current);
+    current++;
+    counters.ticks++;
+    recordChecksum();
+    return true;
+}
+
+void NetSession::poll() {
+    receive();
+    if (rollbackTo != NoFrame)
+        rollback();
+    if (!endIfLeft())
+        sendInputs();
+}
+
+void NetSession::leave() {
+    packet.clear();
+    packet.push_back(Quit);
+    for (int i = 0; i < QuitRepeats; i++) {
+        transport.send(packet);
+        counters.packetsSent++;
+    }
+}
+
+//After any rollback, so a restored state can't bring the run back
+bool NetSession::endIfLeft() {
+    if (!peerLeft.load(memory_order_relaxed) || !sim)
+        return false;
+    sim->game_over = true;
+    return true;
+}
+
+//Saves the state the tick starts from, then steps it with the best input known for it
+void NetSession::simulate(uint64_t frame) {
+    sim->copyStateTo(states[frame % StateSlots]);
+    uint8_t remote = remoteInput(frame);
+    guessed[frame % HistorySize] = remote;
+    InputFrame mine = unpackInput(localInputs[frame % HistorySize]), theirs = unpackInput(remote);
+    if (localPlayer == 0)
+        sim->step(mine, theirs);
+    else
+        sim->step(theirs, mine);
+}
+
+void NetSession::rollback() {
+    uint64_t target = current;
+    states[rollbackTo % StateSlots].copyStateTo(*sim);
+    for (uint64_t frame = rollbackTo; frame < target; frame++)
+        simulate(frame);
+    counters.rollbacks++;
+    counters.resimulatedTicks += target - rollbackTo;
+    counters.longestRollback = max(counters.longestRollback, target - rollbackTo);
+    rollbackTo = NoFrame;
+}
+
+void NetSession::receive() {
+    while (transport.receive(packet)) {
+        counters.packetsReceived++;
+        Reader reader{ packet };
+        uint8_t type = uint8_t(reader.bytes(1));
+        if (type == Hello && localPlayer == 0) {
+            //The Start can get lost, so every Hello gets one until inputs start coming in
+            peerConnected = true;
+            sendStart();
+        }
+        else if (type == Inputs && sim)
+            readInputs(packet);
+        else if (type == Quit && sim)
+            peerLeft.store(true, memory_order_relaxed);
+    }
+}
+
+void NetSession::readInputs(const vector<uint8_t>& data) {
+    Reader reader{ data };
+    reader.bytes(1);
+    uint64_t ack = reader.bytes(4);
+    uint64_t first = reader.bytes(4);
+    int count = int(reader.bytes(1));
+    size_t inputs = reader.offset;
+    reader.offset += count;
+    uint32_t checksumFrame = uint32_t(reader.bytes(4));
+    uint64_t checksum = reader.bytes(8);
+    if (reader.failed)
+        return;
+
+    peerHas = max(peerHas, ack);
+    //Inputs always start at or before what we already have, anything past a gap is dropped
+    for (int i = 0; i < count; i++) {
+        uint64_t frame = first + i;
+        if (frame < remoteEnd)
+            continue;
+        if (frame > remoteEnd)
+            break;
+        uint8_t input = data[inputs + i];
+        remoteInputs[frame % HistorySize] = input;
+        remoteEnd++;
+        if (frame < current && guessed[frame % HistorySize] != input)
+            rollbackTo = min(rollbackTo, frame);
+    }
+    if (checksumFrame != NoChecksum)
+        compareChecksum(checksumFrame, checksum, true);
+}
+
+void NetSession::sendInputs() {
+    //Everything the other side hasn't confirmed goes out every time, so a lost packet costs nothing
+    uint64_t first = peerHas;
+    int count = int(min<uint64_t>(localEnd - first, MaxInputsPerPacket));
+    packet.clear();
+    packet.push_back(Inputs);
+    writeBytes(packet, remoteEnd, 4);
+    writeBytes(packet, first, 4);
+    writeBytes(packet, count, 1);
+    for (int i = 0; i < count; i++)
+        packet.push_back(localInputs[(first + i) % HistorySize]);
+    writeBytes(packet, latestChecksum.frame == NoFrame ? NoChecksum : uint32_t(latestChecksum.frame), 4);
+    writeBytes(packet, latestChecksum.value, 8);
+    transport.send(packet);
+    counters.packetsSent++;
+}
+
+void NetSession::sendStart() {
+    vector<uint8_t> start;
+    start.push_back(Start);
+    start.push_back(ProtocolVersion);
+    writeBytes(start, seed, 8);
+    writeBytes(start, uint8_t(level), 1);
+    transport.send(start);
+    counters.packetsSent++;
+}
+
+//A tick's starting state is final once both inputs for every tick before it are known. The newest
+//such tick on the interval gets checksummed, from the saved states if it's in the past.
+void NetSession::recordChecksum() {
+    uint64_t confirmed = min(current, remoteEnd);
+    uint64_t frame = confirmed / ChecksumInterval * ChecksumInterval;
+    if (frame == 0 || frame == latestChecksum.frame)
+        return;
+    uint64_t value;
+    if (frame == current)
+        value = sim->checksum();
+    else if (frame + StateSlots > current)
+        value = states[frame % StateSlots].checksum();
+    else
+        return;
+    latestChecksum = { frame, value };
+    compareChecksum(frame, value, false);
+}
+
+void NetSession::compareChecksum(uint64_t frame, uint64_t value, bool remote) {
+    int slot = int(frame / ChecksumInterval % ChecksumSlots);
+    (remote ? remoteChecksums : localChecksums)[slot] = { frame, value };
+    const Checksum& other = (remote ? localChecksums : remoteChecksums)[slot];
+    if (other.frame == frame && other.value != value && frame < desyncFrame)
+        desyncFrame = frame;
+}
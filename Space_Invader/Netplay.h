@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "GameSimulation.h"
+
+//Two player co-op between two machines. Both run the whole simulation and only send each other
+//their input, so it has to stay deterministic (the same seed and inputs give the same game).
+//
+//Rollback: a tick never waits for the other side's input. Their last known input is repeated as
+//a guess, and when the real one turns up different the state from that tick is restored and
+//everything since is simulated again with the right input. inputDelay holds local input back a
+//few ticks, which hides that much latency with no rollback at all. rollbackWindow is how far
+//ahead of the other side's input the session will guess before it stops and waits.
+//
+//Sounds and effects come from sim.events of new ticks only. Ticks that get simulated again
+//don't repeat theirs, so a mispredicted tick can be missing an explosion or have one too many.
+
+//Sends and receives whole datagrams and never blocks. UdpTransport is the real one, the loopback
+//harness has one with simulated loss and jitter.
+class Transport {
+public:
+    virtual ~Transport() = default;
+    virtual void send(const std::vector<uint8_t>& packet) = 0;
+    //False when nothing is waiting
+    virtual bool receive(std::vector<uint8_t>& packet) = 0;
+};
+
+struct NetSettings {
+    int inputDelay = 2; //Ticks, both sides don't have to agree
+    int rollbackWindow = 12; //Ticks
+};
+
+struct NetStats {
+    uint64_t ticks = 0;
+    uint64_t stalls = 0; //advance() calls that waited on the other side
+    uint64_t rollbacks = 0;
+    uint64_t resimulatedTicks = 0;
+    uint64_t longestRollback = 0;
+    uint64_t packetsSent = 0, packetsReceived = 0;
+};
+
+class NetSession {
+public:
+    static const int MaxInputDelay = 30;
+    static const int MaxRollbackWindow = 60;
+    static const int ChecksumInterval = 60; //Ticks between state checksums sent for desync checks
+
+    //Player 0 hosts and flies sim.player, player 1 joins and flies sim.partner
+    NetSession(Transport& transport, int localPlayer, NetSettings settings);
+
+    //Call once a frame until it returns true. The host sends seed and level, the joining side
+    //gets them filled in.
+    bool handshake(uint64_t& seed, int& level);
+
+    //Both sides have to set sim up the same way from the handshake (seed, coop, levels, start)
+    //before calling this
+    void begin(GameSimulation& sim);
+
+    //Steps the next tick with this input, after rolling back for any guesses that turned out wrong.
+    //Returns false without stepping while the other side is more than rollbackWindow ticks behind.
+    bool advance(const InputFrame& local);
+    //Takes in whatever arrived and applies the rollbacks it causes without stepping a new tick,
+    //for while the game isn't moving on (waiting on the other side, or the end of a test run)
+    void poll();
+    //Tells the other side this one is gone, so it ends its run instead of waiting on input that
+    //won't come. Sent a few times since nothing confirms it. Not while a thread is advancing.
+    void leave();
+
+    uint64_t frame() const { return current; }
+    int player() const { return localPlayer; }
+    //Both sides checksum the same confirmed ticks, a mismatch means the games have split
+    bool desynced() const { return desyncFrame != NoFrame; }
+    //The other side left, the run was ended with game over. Safe to read from another thread.
+    bool partnerLeft() const { return peerLeft.load(std::memory_order_relaxed); }
+    uint64_t firstDesync() const { return desyncFrame; }
+    const NetStats& stats() const { return counters; }
+    const NetSettings& settings() const { return config; }
+
+private:
+    static const int HistorySize = 256; //Input ring, power of two
+    static const int StateSlots = MaxRollbackWindow + 1;
+    static const int ChecksumSlots = 8;
+    static const uint64_t NoFrame = UINT64_MAX;
+
+    void receive();
+    void readInputs(const std::vector<uint8_t>& packet);
+    void sendInputs();
+    void sendStart();
+    void rollback();
+    bool endIfLeft();
+    void simulate(uint64_t frame);
+    void recordChecksum();
+    void compareChecksum(uint64_t frame, uint64_t value, bool remote);
+
+    uint8_t remoteInput(uint64_t frame) const;
+
+    Transport& transport;
+    int localPlayer;
+    NetSettings config;
+    GameSimulation* sim = nullptr;
+    std::vector<GameSimulation> states; //State before each of the last StateSlots ticks
+
+    uint64_t seed = 0;
+    int level = 1;
+    bool peerConnected = false;
+    std::atomic<bool> peerLeft{ false };
+
+    uint8_t localInputs[HistorySize] = {};
+    uint8_t remoteInputs[HistorySize] = {};
+    uint8_t guessed[HistorySize] = {}; //The remote input each simulated tick actually used
+    uint64_t current = 0; //Next tick to simulate
+    uint64_t localEnd = 0; //Local input is known for ticks before this
+    uint64_t remoteEnd = 0; //Remote input is known, with no gaps, for ticks before this
+    uint64_t peerHas = 0; //The other side has our input for ticks before this
+    uint64_t rollbackTo = NoFrame;
+
+    struct Checksum {
+        uint64_t frame = NoFrame, value = 0;
+    };
+    Checksum localChecksums[ChecksumSlots], remoteChecksums[ChecksumSlots];
+    Checksum latestChecksum;
+    uint64_t desyncFrame = NoFrame;
+
+    NetStats counters;
+    std::vector<uint8_t> packet; //Reused for sending and receiving
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//Fixed number of objects allocated up front. acquire() and release() are O(1) through a free
+//list, objects never move, and nothing is compacted, so holding a pointer across frames is
+//fine until that object is released.
+template <typename T>
+class Pool {
+public:
+    explicit Pool(uint32_t capacity)
+        : items(capacity), used(capacity, 0) {
+        freeSlots.reserve(capacity);
+        //Hand out the low slots first so iteration stays near the front
+        for (uint32_t i = capacity; i > 0; i--)
+            freeSlots.push_back(i - 1);
+    }
+
+    //Copies value into a free slot, returns nullptr when the pool is full
+    T* acquire(const T& value) {
+        if (freeSlots.empty())
+            return nullptr;
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+        items[index] = value;
+        used[index] = 1;
+        return &items[index];
+    }
+
+    void release(uint32_t index) {
+        if (!used[index])
+            return;
+        used[index] = 0;
+        freeSlots.push_back(index);
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < capacity(); i++)
+            release(i);
+    }
+
+    //Calls visitor(T&, index) for every object in use
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) {
+        for (uint32_t i = 0; i < capacity(); i++) {
+            if (used[i])
+                visitor(items[i], i);
+        }
+    }
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const {
+        for (uint32_t i = 0; i < capacity(); i++) {
+            if (used[i])
+                visitor(items[i], i);
+        }
+    }
+
+    uint32_t capacity() const { return uint32_t(items.size()); }
+    uint32_t inUse() const { return capacity() - uint32_t(freeSlots.size()); }
+
+private:
+    std::vector<T> items;
+    std::vector<uint8_t> used;
+    std::vector<uint32_t> freeSlots;
+};
@@ -0,0 +1,95 @@
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+Profiler::Profiler()
+    : Profiler(chrono::steady_clock::now()) {
+}
+
+Profiler::Profiler(chrono::steady_clock::time_point epoch)
+    : epoch(epoch) {
+    zoneList.reserve(MaxZones);
+}
+
+void Profiler::beginFrame() {
+    frameBegin = now();
+}
+
+void Profiler::endFrame() {
+    history[frameCount % HistoryFrames] = (now() - frameBegin) / 1e6f;
+    frameCount++;
+    for (auto& zone : zoneList) {
+        zone.last = zone.current;
+        zone.current = 0;
+    }
+}
+
+void Profiler::record(const char* name, uint64_t begin, uint64_t end, uint32_t thread) {
+    Zone* zone = nullptr;
+    for (auto& existing : zoneList) {
+        if (existing.name == name || strcmp(existing.name, name) == 0) {
+            zone = &existing;
+            break;
+        }
+    }
+    if (!zone && zoneList.size() < MaxZones) {
+        zoneList.push_back({ name, 0, 0 });
+        zone = &zoneList.back();
+    }
+    if (zone)
+        zone->current += end - begin;
+    if (forward)
+        forward->push({ name, begin, end });
+
+    if (capture) {
+        events.push_back({ name, begin, end - begin, thread });
+        if (events.size() >= captureLimit)
+            capture = false;
+    }
+}
+
+void Profiler::startCapture(size_t maxEvents) {
+    events.clear();
+    events.reserve(maxEvents);
+    captureLimit = maxEvents;
+    capture = true;
+}
+
+void Profiler::stopCapture() {
+    capture = false;
+}
+
+bool Profiler::writeTrace(const string& path) const {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out)
+        return false;
+    //Complete ("X") events, timestamps in microseconds
+    fprintf(out, "{\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"main\"}},\n", MainThreadId);
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"simulation\"}}%s\n",
+        SimulationThreadId, events.empty() ? "" : ",");
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& event = events[i];
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n", event.name,
+            event.thread, event.begin / 1000.0, event.duration / 1000.0, i + 1 < events.size() ? "," : "");
+    }
+    fprintf(out, "],\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(out) == 0;
+}
+
+float Profiler::zoneMs(const char* name) const {
+    for (const auto& zone : zoneList) {
+        if (zone.name == name || strcmp(zone.name, name) == 0)
+            return zone.last / 1e6f;
+    }
+    return 0.f;
+}
+
+float Profiler::frameMs(size_t age) const {
+    if (age >= frames())
+        return 0.f;
+    return history[(frameCount - 1 - age) % HistoryFrames];
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SpscQueue.h"
+
+//Scoped timing markers for the main loop and the simulation. Every marker adds to a per-frame
+//total for its name (what the overlay shows), and while a capture is running it's also kept as
+//an event that can be written out in Chrome's trace format (chrome://tracing, ui.perfetto.dev).
+//Names have to be string literals since only the pointer is kept.
+//
+//A Profiler belongs to one thread. Another thread gets its own, started from the same epoch and
+//forwarding its markers through a queue, and the owner records them under that thread's id.
+class Profiler {
+public:
+    static const size_t HistoryFrames = 240;
+    static const size_t MaxZones = 32;
+
+    //Trace thread ids
+    static const uint32_t MainThreadId = 1;
+    static const uint32_t SimulationThreadId = 2;
+
+    struct Marker {
+        const char* name;
+        uint64_t begin, end;
+    };
+    typedef SpscQueue<Marker, 1024> MarkerQueue;
+
+    struct Zone {
+        const char* name;
+        uint64_t current; //Nanoseconds so far this frame
+        uint64_t last; //Total for the last finished frame
+    };
+
+    Profiler();
+    explicit Profiler(std::chrono::steady_clock::time_point epoch);
+
+    std::chrono::steady_clock::time_point started() const { return epoch; }
+    //Nanoseconds since started()
+    uint64_t now() const {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void beginFrame();
+    void endFrame();
+    void record(const char* name, uint64_t begin, uint64_t end, uint32_t thread = MainThreadId);
+
+    //Every marker is also pushed to the queue, dropped when the other side is behind
+    void forwardTo(MarkerQueue* queue) { forward = queue; }
+
+    //Keeps every marker until stopCapture(), up to maxEvents of them
+    void startCapture(size_t maxEvents = 1 << 20);
+    void stopCapture();
+    bool capturing() const { return capture; }
+    bool writeTrace(const std::string& path) const;
+
+    const std::vector<Zone>& zones() const { return zoneList; }
+    float zoneMs(const char* name) const;
+
+    //Frame times in ms, oldest first once the history has wrapped
+    float frameMs(size_t age) const; //0 is the newest finished frame
+    size_t frames() const { return frameCount < HistoryFrames ? size_t(frameCount) : HistoryFrames; }
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t begin, duration;
+        uint32_t thread;
+    };
+
+    std::chrono::steady_clock::time_point epoch;
+    MarkerQueue* forward = nullptr;
+    std::vector<Zone> zoneList;
+    std::vector<Event> events;
+    bool capture = false;
+    size_t captureLimit = 0;
+
+    float history[HistoryFrames] = {};
+    uint64_t frameCount = 0;
+    uint64_t frameBegin = 0;
+};
+
+//Times the enclosing block, a null profiler turns it into nothing
+struct ProfileScope {
+    Profiler* profiler;
+    const char* name;
+    uint64_t begin;
+
+    ProfileScope(Profiler* profiler, const char* name)
+        : profiler(profiler), name(name), begin(profiler ? profiler->now() : 0) {
+    }
+    ~ProfileScope() {
+        if (profiler)
+            profiler->record(name, begin, profiler->now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
@@ -0,0 +1,73 @@
+#include "ProfilerOverlay.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const Vector2f Origin(470.f, 10.f);
+    const float GraphHeight = 60.f;
+    const float GraphScale = 33.3f; //ms at the top of the graph
+    const float BudgetMs = 1000.f / 60.f;
+    const float TextRefresh = 0.25f;
+}
+
+ProfilerOverlay::ProfilerOverlay(const ResourceCache<Font>::Handle& font)
+    : font(font), background(Vector2f(Profiler::HistoryFrames, 250.f)), graph(Lines, Profiler::HistoryFrames * 2), budget(Lines, 2), text("", *font, 8) {
+    background.setPosition(Origin);
+    background.setFillColor(Color(0, 0, 0, 180));
+    float budgetY = Origin.y + GraphHeight - GraphHeight * BudgetMs / GraphScale;
+    budget[0] = Vertex(Vector2f(Origin.x, budgetY), Color(255, 255, 255, 120));
+    budget[1] = Vertex(Vector2f(Origin.x + Profiler::HistoryFrames, budgetY), Color(255, 255, 255, 120));
+    text.setPosition(Origin + Vector2f(4.f, GraphHeight + 6.f));
+    text.setFillColor(Color::White);
+    buffer.reserve(1024);
+}
+
+void ProfilerOverlay::update(const Profiler& profiler, const OverlayCounts& counts) {
+    if (!visible)
+        return;
+
+    //Newest frame on the right
+    float total = 0.f, worst = 0.f;
+    size_t frames = profiler.frames();
+    for (size_t i = 0; i < Profiler::HistoryFrames; i++) {
+        float ms = profiler.frameMs(i);
+        total += ms;
+        worst = max(worst, ms);
+        float x = Origin.x + Profiler::HistoryFrames - 1 - i;
+        float height = GraphHeight * min(ms / GraphScale, 1.f);
+        Color color = ms <= BudgetMs ? Color::Green : ms <= 2 * BudgetMs ? Color::Yellow : Color::Red;
+        graph[i * 2] = Vertex(Vector2f(x, Origin.y + GraphHeight), color);
+        graph[i * 2 + 1] = Vertex(Vector2f(x, Origin.y + GraphHeight - height), color);
+    }
+
+    if (textClock.getElapsedTime().asSeconds() < TextRefresh)
+        return;
+    textClock.restart();
+
+    char line[96];
+    buffer.clear();
+    snprintf(line, sizeof(line), "frame %.2f ms avg  %.2f max\n\n", frames ? total / frames : 0.f, worst);
+    buffer += line;
+    for (const auto& zone : profiler.zones()) {
+        snprintf(line, sizeof(line), "%-12s %6.3f ms\n", zone.name, zone.last / 1e6);
+        buffer += line;
+    }
+    snprintf(line, sizeof(line), "%-12s %6.3f ms\n", "sim tick", counts.tickMs);
+    buffer += line;
+    snprintf(line, sizeof(line), "\nenemies %u  bullets %u\nexplosions %u  voices %u\ndraw calls %u  quads %u\n",
+        counts.enemies, counts.bullets, counts.animations, counts.voices, counts.drawCalls, counts.quads);
+    buffer += line;
+    buffer += "\nF3 overlay  F4 trace capture";
+    text.setString(buffer);
+}
+
+void ProfilerOverlay::draw(RenderTarget& target, RenderStates states) const {
+    target.draw(background, states);
+    target.draw(graph, states);
+    target.draw(budget, states);
+    target.draw(text, states);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "Profiler.h"
+#include "ResourceCache.h"
+
+//What the overlay lists besides the timings, filled in by the main loop
+struct OverlayCounts {
+    unsigned enemies = 0;
+    unsigned bullets = 0;
+    unsigned animations = 0;
+    unsigned drawCalls = 0;
+    unsigned quads = 0;
+    unsigned voices = 0;
+    float tickMs = 0.f; //Last step() on the simulation thread
+};
+
+//Frame time graph plus the per-zone timings and counts, drawn over the top right of the game.
+//The graph is rebuilt every frame into a fixed vertex array. The text only changes a few
+//times a second, since rebuilding an sf::Text every frame would cost more than the loop it measures.
+class ProfilerOverlay : public sf::Drawable {
+public:
+    bool visible = false;
+
+    explicit ProfilerOverlay(const ResourceCache<sf::Font>::Handle& font);
+
+    void update(const Profiler& profiler, const OverlayCounts& counts);
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    ResourceCache<sf::Font>::Handle font;
+    sf::RectangleShape background;
+    sf::VertexArray graph; //One vertical line per frame
+    sf::VertexArray budget; //Where 60 fps is
+    sf::Text text;
+    sf::Clock textClock;
+    std::string buffer;
+};
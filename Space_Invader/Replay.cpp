@@ -0,0 +1,160 @@
+#include "Replay.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+    const char Magic[4] = { 'S', 'I', 'R', 'P' };
+    //2: enemy fire moved to a schedule. 3: hits are tested against collision masks.
+    //Older runs play out differently now.
+    const uint16_t Version = 3;
+
+    void writeBytes(vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    void writeVarint(vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(uint8_t(value));
+    }
+
+    //Reads from a buffer, any read past the end sets failed instead of going out of bounds
+    struct Reader {
+        const vector<uint8_t>& data;
+        size_t offset = 0;
+        bool failed = false;
+
+        uint64_t bytes(int count) {
+            if (offset + count > data.size()) {
+                failed = true;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < count; i++)
+                value |= uint64_t(data[offset++]) << (8 * i);
+            return value;
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint64_t byte = bytes(1);
+                if (failed)
+                    return 0;
+                value |= (byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            failed = true;
+            return 0;
+        }
+    };
+}
+
+uint8_t packInput(const InputFrame& input) {
+    return (input.left ? InputBits::Left : 0) | (input.right ? InputBits::Right : 0) | (input.fire ? InputBits::Fire : 0);
+}
+
+InputFrame unpackInput(uint8_t bits) {
+    InputFrame input;
+    input.left = (bits & InputBits::Left) != 0;
+    input.right = (bits & InputBits::Right) != 0;
+    input.fire = (bits & InputBits::Fire) != 0;
+    return input;
+}
+
+void Replay::begin(uint64_t runSeed, int level, float intro) {
+    seed = runSeed;
+    startLevel = level;
+    introTime = intro;
+    finalChecksum = 0;
+    inputs.clear();
+    //Ten minutes up front so recording doesn't allocate while playing
+    inputs.reserve(size_t(TickRate) * 600);
+}
+
+void Replay::finish(const GameSimulation& sim) {
+    finalChecksum = sim.checksum();
+}
+
+void Replay::restart(GameSimulation& sim) const {
+    sim = GameSimulation(seed);
+    sim.start(startLevel, introTime);
+}
+
+bool Replay::save(const string& path) const {
+    vector<uint8_t> out(Magic, Magic + 4);
+    uint32_t intro;
+    memcpy(&intro, &introTime, sizeof(intro));
+    writeBytes(out, Version, 2);
+    writeBytes(out, seed, 8);
+    writeBytes(out, uint8_t(startLevel), 1);
+    writeBytes(out, intro, 4);
+    writeBytes(out, uint32_t(inputs.size()), 4);
+    writeBytes(out, finalChecksum, 8);
+
+    //Only the ticks where the input changed are written. Tick 0 always counts as a change.
+    size_t last = 0;
+    for (size_t tick = 0; tick < inputs.size(); tick++) {
+        if (tick > 0 && inputs[tick] == inputs[tick - 1])
+            continue;
+        writeVarint(out, tick - last);
+        out.push_back(inputs[tick]);
+        last = tick;
+    }
+
+    ofstream file(path, ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return bool(file);
+}
+
+bool Replay::load(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file)
+        return false;
+    vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    if (data.size() < 4 || memcmp(data.data(), Magic, 4) != 0)
+        return false;
+
+    Reader reader{ data, 4 };
+    if (reader.bytes(2) != Version)
+        return false;
+    uint64_t fileSeed = reader.bytes(8);
+    int level = int(reader.bytes(1));
+    uint32_t intro = uint32_t(reader.bytes(4));
+    uint32_t tickCount = uint32_t(reader.bytes(4));
+    uint64_t checksum = reader.bytes(8);
+    if (reader.failed)
+        return false;
+
+    //Expand the changes back into one entry per tick
+    vector<uint8_t> expanded;
+    expanded.reserve(tickCount);
+    size_t tick = 0;
+    uint8_t current = 0;
+    for (bool first = true; reader.offset < data.size(); first = false) {
+        uint64_t gap = reader.varint();
+        uint8_t bits = uint8_t(reader.bytes(1));
+        //Only the first change can be at tick 0, after that every change moves forward
+        if (reader.failed || (gap == 0 && !first) || gap >= tickCount - tick)
+            return false;
+        expanded.insert(expanded.end(), size_t(gap), current);
+        tick += size_t(gap);
+        current = bits;
+    }
+    expanded.insert(expanded.end(), tickCount - expanded.size(), current);
+
+    seed = fileSeed;
+    startLevel = level;
+    memcpy(&introTime, &intro, sizeof(introTime));
+    finalChecksum = checksum;
+    inputs.swap(expanded);
+    return true;
+}
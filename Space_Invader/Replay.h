@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameSimulation.h"
+
+//A run is fully described by its seed, how it was started and what was pressed on every tick,
+//since GameSimulation::step() depends on nothing else. Replays store exactly that.
+//
+//File layout, all little endian:
+//    "SIRP", u16 version, u64 seed, u8 start level, f32 intro time, u32 tick count, u64 final checksum
+//    then one record per input change: varint ticks since the previous change, u8 input bits
+//A run that holds fire and moves now and then comes out at a few bytes per second.
+
+namespace InputBits {
+    const uint8_t Left = 1;
+    const uint8_t Right = 2;
+    const uint8_t Fire = 4;
+}
+
+uint8_t packInput(const InputFrame& input);
+InputFrame unpackInput(uint8_t bits);
+
+struct Replay {
+    uint64_t seed = 0;
+    int startLevel = 1;
+    float introTime = 0.f;
+    uint64_t finalChecksum = 0; //GameSimulation::checksum() after the last tick, 0 if not known
+    std::vector<uint8_t> inputs; //One set of input bits per tick, unpacked in memory
+
+    //Forgets any recorded input and starts over for a new run
+    void begin(uint64_t runSeed, int level, float intro);
+    void record(const InputFrame& input) {
+        inputs.push_back(packInput(input));
+    }
+    //Stores the checksum so playback can tell if it went out of sync
+    void finish(const GameSimulation& sim);
+
+    size_t ticks() const { return inputs.size(); }
+    InputFrame input(size_t tick) const {
+        return tick < inputs.size() ? unpackInput(inputs[tick]) : InputFrame();
+    }
+
+    //Puts sim in the state the recording started from
+    void restart(GameSimulation& sim) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
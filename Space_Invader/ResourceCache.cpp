@@ -0,0 +1,31 @@
+#include "ResourceCache.h"
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    void printCache(ostream& out, const char* name, const CacheStats& stats) {
+        out << "  " << name << ": " << stats.entries << " loaded, " << stats.hits << " hits, " << stats.misses << " misses, "
+            << stats.bytes / 1024 << " KiB\n";
+    }
+}
+
+//SFML reads glyphs from the font's bytes on demand, which stay in the archive
+size_t resourceBytes(const Font&, const AssetData* file) {
+    return file ? file->size : 0;
+}
+
+size_t resourceBytes(const SoundBuffer& buffer, const AssetData*) {
+    return size_t(buffer.getSampleCount()) * sizeof(Int16);
+}
+
+void Resources::release() {
+    fonts.release();
+    sounds.release();
+}
+
+void Resources::printStats(ostream& out) const {
+    out << "Resources:\n";
+    printCache(out, "fonts", fonts.getStats());
+    printCache(out, "sounds", sounds.getStats());
+}
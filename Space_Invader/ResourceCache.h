@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+#include "AssetArchive.h"
+
+//Roughly how much memory a loaded resource keeps around, for the cache stats. file is where it
+//was loaded from, nullptr if the archive doesn't have it.
+size_t resourceBytes(const sf::Font& font, const AssetData* file);
+size_t resourceBytes(const sf::SoundBuffer& buffer, const AssetData* file);
+
+struct CacheStats {
+    unsigned hits = 0; //get() calls answered from the cache
+    unsigned misses = 0; //get() calls that had to load from the archive
+    size_t bytes = 0; //Held by everything currently cached
+    size_t entries = 0;
+};
+
+//Loads each file once and hands out shared handles to it. The cache keeps its own reference,
+//so a resource stays loaded until release() finds nobody else is still using it.
+//Everything comes out of the asset archive, the same place the loader reads from.
+template <typename T>
+class ResourceCache {
+public:
+    using Handle = std::shared_ptr<const T>;
+
+    explicit ResourceCache(const AssetArchive& archive) : archive(archive) {}
+
+    Handle get(const std::string& path) {
+        auto found = entries.find(path);
+        if (found != entries.end()) {
+            stats.hits++;
+            return found->second.resource;
+        }
+
+        auto resource = std::make_shared<T>();
+        //A failed load still gets cached (empty), so a missing asset is only reported once
+        const AssetData* file = archive.find(path);
+        if (!file)
+            std::cout << "Failed to load " << path << ", it isn't in the assets\n";
+        else if (!resource->loadFromMemory(file->data, file->size))
+            std::cout << "Failed to load " << path << "\n";
+        insert(path, resource);
+        return resource;
+    }
+
+    //Takes a resource that was loaded somewhere else (the asset loader's threads)
+    void insert(const std::string& path, const std::shared_ptr<T>& resource) {
+        if (entries.count(path))
+            return;
+        stats.misses++;
+        Entry entry{ resource, resourceBytes(*resource, archive.find(path)) };
+        stats.bytes += entry.bytes;
+        entries.emplace(path, entry);
+        stats.entries = entries.size();
+    }
+
+    //Drops everything only the cache is holding on to
+    void release() {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.resource.use_count() == 1) {
+                stats.bytes -= it->second.bytes;
+                it = entries.erase(it);
+            }
+            else
+                ++it;
+        }
+        stats.entries = entries.size();
+    }
+
+    const CacheStats& getStats() const {
+        return stats;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<T> resource;
+        size_t bytes;
+    };
+    const AssetArchive& archive;
+    std::map<std::string, Entry> entries;
+    CacheStats stats;
+};
+
+//Every cache the front end uses, so they can be passed around and reported together
+struct Resources {
+    ResourceCache<sf::Font> fonts;
+    ResourceCache<sf::SoundBuffer> sounds;
+
+    explicit Resources(const AssetArchive& archive) : fonts(archive), sounds(archive) {}
+
+    void release();
+    void printStats(std::ostream& out) const;
+};
@@ -0,0 +1,198 @@
+#include "SimulationThread.h"
+
+#include <chrono>
+
+#include "Replay.h"
+
+using namespace std;
+
+namespace {
+    //After a stall longer than this the simulation skips ahead instead of running every missed tick
+    const int MaxCatchUpTicks = 30;
+
+    uint64_t nanoseconds(chrono::steady_clock::time_point time) {
+        return uint64_t(chrono::duration_cast<chrono::nanoseconds>(time.time_since_epoch()).count());
+    }
+}
+
+void Snapshot::capture(const GameSimulation& sim) {
+    tick = sim.tick;
+    playerPosition = sim.player.position;
+    playerPrevious = sim.player.previous;
+    playerDirection = sim.player.direction;
+    playerFrame = sim.player.frame();
+    invulnerability = sim.player.invulnerability;
+    coop = sim.coop;
+    if (coop) {
+        partnerPosition = sim.partner.position;
+        partnerPrevious = sim.partner.previous;
+        partnerDirection = sim.partner.direction;
+        partnerFrame = sim.partner.frame();
+        partnerInvulnerability = sim.partner.invulnerability;
+    }
+    lives = sim.lives;
+    score = sim.global_score;
+    level = sim.level;
+    playing = sim.playing();
+    intro = sim.inIntro();
+    gameOver = sim.game_over;
+    gameWin = sim.game_win;
+
+    const EnemyStore& e = sim.enemies;
+    enemies.clear();
+    for (uint32_t i = 0; i < e.slots.slots(); i++) {
+        if (e.slots.alive[i])
+            enemies.push_back({ e.x[i], e.y[i], e.color[i], uint8_t(e.skin[i]), e.flip[i] != 0, e.updating[i] > 0.f });
+    }
+    const BulletStore& b = sim.bullets;
+    bullets.clear();
+    for (uint32_t i = 0; i < b.slots.slots(); i++) {
+        if (b.slots.alive[i])
+            bullets.push_back({ b.previousX[i], b.previousY[i], b.x[i], b.y[i], b.color[i], b.skin[i] });
+    }
+}
+
+SimulationThread::SimulationThread(GameSimulation& sim)
+    : sim(sim) {
+    publish();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start(InputSource inputSource, StepListener stepped) {
+    stop();
+    source = move(inputSource);
+    listener = move(stepped);
+    heldInput.store(0);
+    fireTapped.store(false);
+    quit.store(false);
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    if (!thread.joinable())
+        return;
+    quit.store(true, memory_order_release);
+    thread.join();
+    source = nullptr;
+    listener = nullptr;
+    sim.profiler = nullptr;
+    //Anything set while it was shutting down still has to reach the simulation
+    if (levelsChanged.exchange(false)) {
+        lock_guard<mutex> lock(levelsLock);
+        sim.setLevels(move(pendingLevels));
+    }
+    publish();
+}
+
+void SimulationThread::setInput(const InputFrame& input) {
+    heldInput.store(packInput(input), memory_order_relaxed);
+    if (input.fire)
+        fireTapped.store(true, memory_order_relaxed);
+}
+
+void SimulationThread::setLevels(shared_ptr<const LevelSet> levels) {
+    if (!running()) {
+        sim.setLevels(move(levels));
+        return;
+    }
+    lock_guard<mutex> lock(levelsLock);
+    pendingLevels = move(levels);
+    levelsChanged.store(true, memory_order_release);
+}
+
+const Snapshot& SimulationThread::latest() {
+    snapshots.acquire();
+    return snapshots.front();
+}
+
+void SimulationThread::refresh() {
+    if (!running())
+        publish();
+}
+
+void SimulationThread::setProfiler(Profiler* profiler) {
+    if (running())
+        return;
+    mainProfiler = profiler;
+    if (profiler) {
+        tickProfiler = Profiler(profiler->started());
+        tickProfiler.forwardTo(&markers);
+    }
+}
+
+void SimulationThread::drainProfile() {
+    Profiler::Marker marker;
+    while (markers.pop(marker)) {
+        if (mainProfiler)
+            mainProfiler->record(marker.name, marker.begin, marker.end, Profiler::SimulationThreadId);
+    }
+}
+
+void SimulationThread::publish() {
+    Snapshot& snapshot = snapshots.back();
+    snapshot.capture(sim);
+    snapshot.time = nanoseconds(chrono::steady_clock::now());
+    snapshot.stepNanoseconds = lastStep;
+    snapshots.publish();
+}
+
+void SimulationThread::run() {
+    typedef chrono::steady_clock Clock;
+    const auto tickLength = chrono::duration_cast<Clock::duration>(chrono::duration<double>(TickDuration));
+
+    sim.profiler = mainProfiler ? &tickProfiler : nullptr;
+    Clock::time_point next = Clock::now();
+    while (!quit.load(memory_order_acquire)) {
+        Clock::time_point now = Clock::now();
+        if (now - next > tickLength * MaxCatchUpTicks)
+            next = now;
+
+        bool stepped = false;
+        while (next <= now && sim.playing()) {
+            if (levelsChanged.exchange(false, memory_order_acquire)) {
+                lock_guard<mutex> lock(levelsLock);
+                sim.setLevels(move(pendingLevels));
+            }
+            InputFrame input = unpackInput(heldInput.load(memory_order_relaxed));
+            bool tapped = fireTapped.exchange(false, memory_order_relaxed);
+            input.fire = input.fire || tapped;
+            if (source)
+                input = source(input);
+
+            Clock::time_point begin = Clock::now();
+            tickProfiler.beginFrame();
+            if (session && !session->advance(input)) {
+                //Too far ahead of the other machine. This tick's slot is skipped so this side
+                //slows down to its pace, and the tap waits for the next one.
+                if (tapped)
+                    fireTapped.store(true, memory_order_relaxed);
+                //It can also have ended the run (the other side left), which still has to be shown
+                stepped = stepped || !sim.playing();
+                next += tickLength;
+                continue;
+            }
+            if (!session)
+                sim.step(input);
+            tickProfiler.endFrame();
+            if (listener)
+                listener(sim);
+            lastStep = uint64_t(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - begin).count());
+
+            for (const auto& event : sim.events) {
+                if (!events.push(event))
+                    dropped.fetch_add(1, memory_order_relaxed);
+            }
+            next += tickLength;
+            stepped = true;
+        }
+        //One snapshot per wake up, the renderer only ever wants the newest tick
+        if (stepped)
+            publish();
+        if (!sim.playing())
+            next = Clock::now() + tickLength;
+        this_thread::sleep_until(next);
+    }
+}
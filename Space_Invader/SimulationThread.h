@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GameSimulation.h"
+#include "Netplay.h"
+#include "Profiler.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+//Everything the renderer needs from one tick, copied out so it can be drawn while the next
+//tick is already being simulated. The vectors keep their capacity between captures.
+struct Snapshot {
+    uint64_t tick = 0;
+    uint64_t time = 0; //steady_clock nanoseconds when the tick finished, for interpolation
+    uint64_t stepNanoseconds = 0; //How long the last step() took
+    Vec2 playerPosition = { 0.f, 0.f }, playerPrevious = { 0.f, 0.f };
+    int playerDirection = 0, playerFrame = 0;
+    float invulnerability = 0.f;
+    bool coop = false; //The partner fields are only filled in for co-op
+    Vec2 partnerPosition = { 0.f, 0.f }, partnerPrevious = { 0.f, 0.f };
+    int partnerDirection = 0, partnerFrame = 0;
+    float partnerInvulnerability = 0.f;
+    int lives = 0, score = 0, level = 0;
+    bool playing = false, intro = false, gameOver = false, gameWin = false;
+
+    struct Enemy {
+        float x, y;
+        uint32_t color;
+        uint8_t skin;
+        bool flip, flash;
+    };
+    struct Bullet {
+        float previousX, previousY, x, y;
+        uint32_t color;
+        BulletSkin skin;
+    };
+    std::vector<Enemy> enemies;
+    std::vector<Bullet> bullets;
+
+    void capture(const GameSimulation& sim);
+};
+
+//Runs the simulation on its own thread at TickRate so a tick can be simulated while the last
+//one is being drawn. The main thread gives it input with setInput(), reads the newest finished
+//tick with latest() and takes the events with popEvent() for sounds and effects.
+//
+//While it's running the main thread must not touch the GameSimulation, stop() hands it back.
+class SimulationThread {
+public:
+    //Called on the simulation thread before every step with the live input, returns what to
+    //actually feed the step (a replay's input, say) and can record it
+    typedef std::function<InputFrame(const InputFrame& live)> InputSource;
+    //Called on the simulation thread after every step, with the state that step left
+    typedef std::function<void(const GameSimulation& sim)> StepListener;
+
+    static const size_t EventCapacity = 1024;
+
+    explicit SimulationThread(GameSimulation& sim);
+    ~SimulationThread();
+
+    void start(InputSource source = nullptr, StepListener stepped = nullptr);
+    void stop();
+    bool running() const { return thread.joinable(); }
+
+    //Held keys are read every tick, a fire tap is kept until a tick has seen it
+    void setInput(const InputFrame& input);
+
+    //Takes effect between ticks, or straight away when stopped
+    void setLevels(std::shared_ptr<const LevelSet> levels);
+
+    //Co-op: ticks go through the session instead of straight to the simulation. Only while
+    //stopped, null goes back to playing alone.
+    void setSession(NetSession* netSession) { session = netSession; }
+
+    //Newest finished tick. Also correct while stopped, stop() and refresh() publish the final state.
+    const Snapshot& latest();
+    void refresh(); //Republishes after the main thread changed the stopped simulation
+
+    bool popEvent(GameEvent& event) { return events.pop(event); }
+    uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+    //Marks the phases of every tick in the main thread's profiler, on the simulation's own trace
+    //thread. Only while stopped, null turns it off. drainProfile() records what came in since the
+    //last call, once a frame before the profiler's endFrame().
+    void setProfiler(Profiler* profiler);
+    void drainProfile();
+
+private:
+    void run();
+    void publish();
+
+    GameSimulation& sim;
+    NetSession* session = nullptr;
+    InputSource source;
+    StepListener listener;
+    std::thread thread;
+    std::atomic<bool> quit{ false };
+
+    std::atomic<uint8_t> heldInput{ 0 }; //packInput bits
+    std::atomic<bool> fireTapped{ false };
+
+    std::mutex levelsLock; //Only taken when the levels get reloaded
+    std::shared_ptr<const LevelSet> pendingLevels;
+    std::atomic<bool> levelsChanged{ false };
+
+    TripleBuffer<Snapshot> snapshots;
+    SpscQueue<GameEvent, EventCapacity> events;
+    std::atomic<uint64_t> dropped{ 0 };
+    uint64_t lastStep = 0;
+
+    Profiler* mainProfiler = nullptr;
+    Profiler tickProfiler; //Used by the simulation thread, shares the main profiler's epoch
+    Profiler::MarkerQueue markers;
+};
@@ -0,0 +1,46 @@
+#include "SpriteBatch.h"
+
+using namespace sf;
+
+SpriteBatch::SpriteBatch(const Texture& atlasTexture)
+    : texture(&atlasTexture), vertices(Triangles), drawCalls(0), quads(0) {
+}
+
+void SpriteBatch::beginFrame() {
+    vertices.clear();
+    drawCalls = 0;
+    quads = 0;
+}
+
+void SpriteBatch::draw(const IntRect& region, Vector2f position, Color color) {
+    float left = float(region.left), top = float(region.top);
+    float right = left + region.width, bottom = top + region.height;
+    Vector2f size(float(region.width), float(region.height));
+
+    //Two triangles per quad
+    Vertex topLeft(position, color, Vector2f(left, top));
+    Vertex topRight(position + Vector2f(size.x, 0.f), color, Vector2f(right, top));
+    Vertex bottomRight(position + size, color, Vector2f(right, bottom));
+    Vertex bottomLeft(position + Vector2f(0.f, size.y), color, Vector2f(left, bottom));
+    vertices.append(topLeft);
+    vertices.append(topRight);
+    vertices.append(bottomRight);
+    vertices.append(topLeft);
+    vertices.append(bottomRight);
+    vertices.append(bottomLeft);
+    quads++;
+}
+
+void SpriteBatch::drawDirect(RenderTarget& target, const Drawable& drawable) {
+    flush(target);
+    target.draw(drawable);
+    drawCalls++;
+}
+
+void SpriteBatch::flush(RenderTarget& target) {
+    if (vertices.getVertexCount() == 0)
+        return;
+    target.draw(vertices, RenderStates(texture));
+    drawCalls++;
+    vertices.clear();
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+//Collects quads that all use the atlas texture and sends them to the GPU in one draw call.
+//Anything that can't go in the batch (the loading bar, the profiler overlay) is drawn through
+//drawDirect, which flushes first so the painter's order stays the same.
+struct SpriteBatch {
+    const sf::Texture* texture;
+    sf::VertexArray vertices;
+    unsigned drawCalls; //Draw calls issued since beginFrame()
+    unsigned quads; //Quads batched since beginFrame()
+
+    explicit SpriteBatch(const sf::Texture& atlasTexture);
+
+    void beginFrame();
+    void draw(const sf::IntRect& region, sf::Vector2f position, sf::Color color = sf::Color::White);
+    void drawDirect(sf::RenderTarget& target, const sf::Drawable& drawable);
+    void flush(sf::RenderTarget& target);
+};
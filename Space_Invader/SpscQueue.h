@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+//Fixed size ring buffer for exactly one thread pushing and one thread popping. No locks and no
+//allocation, each side only writes its own index. push() fails when the queue is full, the
+//producer decides what to do about it (the simulation just counts the event as dropped).
+//Capacity has to be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items[tail & (Capacity - 1)] = item;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire))
+            return false;
+        item = items[head & (Capacity - 1)];
+        readIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //Only exact when neither side is running
+    size_t size() const { return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire); }
+
+private:
+    std::array<T, Capacity> items;
+    //On separate cache lines so the two threads don't keep stealing the line from each other
+    alignas(64) std::atomic<size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<size_t> readIndex{ 0 };
+};
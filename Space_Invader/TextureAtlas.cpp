@@ -0,0 +1,80 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const unsigned Padding = 1;
+}
+
+bool TextureAtlas::add(const string& name, const string& path) {
+    Image image;
+    if (!image.loadFromFile(path)) {
+        cout << "Failed to load " << path << " into the atlas\n";
+        return false;
+    }
+    add(name, image);
+    return true;
+}
+
+void TextureAtlas::add(const string& name, const Image& image) {
+    pending.push_back({ name, image });
+}
+
+bool TextureAtlas::build(unsigned maxWidth) {
+    //Tallest first keeps the shelves tight
+    vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return pending[a].image.getSize().y > pending[b].image.getSize().y;
+    });
+
+    unsigned x = 0, y = 0, shelfHeight = 0, width = 0;
+    vector<Vector2u> positions(pending.size());
+    for (size_t i : order) {
+        Vector2u size = pending[i].image.getSize();
+        if (size.x + Padding > maxWidth) {
+            cout << "Atlas image " << pending[i].name << " is wider than the atlas\n";
+            return false;
+        }
+        if (x + size.x + Padding > maxWidth) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        positions[i] = Vector2u(x, y);
+        x += size.x + Padding;
+        width = max(width, x);
+        shelfHeight = max(shelfHeight, size.y + Padding);
+    }
+    unsigned height = y + shelfHeight;
+
+    Image atlas;
+    atlas.create(max(width, 1u), max(height, 1u), Color::Transparent);
+    for (size_t i = 0; i < pending.size(); i++) {
+        Vector2u size = pending[i].image.getSize();
+        atlas.copy(pending[i].image, positions[i].x, positions[i].y);
+        regions[pending[i].name] = IntRect(positions[i].x, positions[i].y, size.x, size.y);
+    }
+    pending.clear();
+    return texture.loadFromImage(atlas);
+}
+
+IntRect TextureAtlas::region(const string& name) const {
+    auto found = regions.find(name);
+    if (found == regions.end()) {
+        cout << "Atlas has no image called " << name << "\n";
+        return IntRect();
+    }
+    return found->second;
+}
+
+IntRect subRect(const IntRect& region, const IntRect& rect) {
+    int left = min(rect.left, region.width);
+    int top = min(rect.top, region.height);
+    return IntRect(region.left + left, region.top + top, min(rect.width, region.width - left), min(rect.height, region.height - top));
+}
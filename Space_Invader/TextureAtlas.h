@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+//All the sprite sheets packed into one texture at startup, so every game sprite can be
+//drawn from the same texture in a single batch. Images are placed on shelves (rows) from
+//tallest to shortest with a transparent pixel of padding so neighbours never bleed in.
+struct TextureAtlas {
+    sf::Texture texture;
+
+    //Queues an image for packing, returns false if it couldn't be loaded
+    bool add(const std::string& name, const std::string& path);
+    void add(const std::string& name, const sf::Image& image);
+
+    //Packs everything queued so far and uploads it. Call once, before region() is used.
+    bool build(unsigned maxWidth = 2048);
+
+    //Where a packed image ended up, in atlas pixels
+    sf::IntRect region(const std::string& name) const;
+
+private:
+    struct Entry {
+        std::string name;
+        sf::Image image;
+    };
+    std::vector<Entry> pending;
+    std::map<std::string, sf::IntRect> regions;
+};
+
+//A piece of a region, clipped so it can't reach into whatever got packed next to it
+sf::IntRect subRect(const sf::IntRect& region, const sf::IntRect& rect);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//Hands the newest copy of something from one writer thread to one reader thread without either
+//ever waiting. The writer fills back(), then publish() swaps it with the spare buffer. The reader's
+//acquire() swaps the spare with its front buffer if something new was published, and front()
+//stays untouched by the writer until the next acquire(). Frames the reader was too slow to
+//pick up are simply replaced.
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return buffers[backIndex]; }
+    const T& front() const { return buffers[frontIndex]; }
+
+    void publish() {
+        uint8_t previous = spare.exchange(uint8_t(backIndex | FreshBit), std::memory_order_acq_rel);
+        backIndex = previous & IndexMask;
+    }
+
+    //Returns true if front() changed
+    bool acquire() {
+        if (!(spare.load(std::memory_order_relaxed) & FreshBit))
+            return false;
+        uint8_t previous = spare.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & IndexMask;
+        return true;
+    }
+
+private:
+    static const uint8_t IndexMask = 3;
+    static const uint8_t FreshBit = 4; //Set while the spare holds something the reader hasn't seen
+
+    T buffers[3];
+    uint8_t backIndex = 0; //Writer only
+    uint8_t frontIndex = 1; //Reader only
+    std::atomic<uint8_t> spare{ 2 };
+};
@@ -0,0 +1,56 @@
+#include "UdpTransport.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace sf;
+
+bool UdpTransport::host(unsigned short port) {
+    if (socket.bind(port) != Socket::Done) {
+        cout << "Couldn't listen on port " << port << "\n";
+        return false;
+    }
+    socket.setBlocking(false);
+    return true;
+}
+
+bool UdpTransport::join(const string& address, unsigned short port) {
+    peer = IpAddress(address);
+    peerPort = port;
+    if (peer == IpAddress::None) {
+        cout << "Couldn't resolve " << address << "\n";
+        return false;
+    }
+    if (socket.bind(Socket::AnyPort) != Socket::Done) {
+        cout << "Couldn't open a socket\n";
+        return false;
+    }
+    socket.setBlocking(false);
+    return true;
+}
+
+void UdpTransport::send(const vector<uint8_t>& packet) {
+    //The host has nobody to send to until the other side says hello
+    if (peer == IpAddress::None)
+        return;
+    //A full send buffer is the same as a lost packet, the session resends anyway
+    socket.send(packet.data(), packet.size(), peer, peerPort);
+}
+
+bool UdpTransport::receive(vector<uint8_t>& packet) {
+    size_t received;
+    IpAddress sender;
+    unsigned short senderPort;
+    while (socket.receive(buffer, sizeof(buffer), received, sender, senderPort) == Socket::Done) {
+        if (peer == IpAddress::None) {
+            peer = sender;
+            peerPort = senderPort;
+        }
+        //Anybody else sending to the port gets ignored
+        if (sender != peer || senderPort != peerPort)
+            continue;
+        packet.assign(buffer, buffer + received);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SFML/Network.hpp>
+
+#include "Netplay.h"
+
+//Netplay over a non-blocking UDP socket. The host listens on a port and talks to whoever
+//sends it the first packet, the joining side knows the host's address up front.
+class UdpTransport : public Transport {
+public:
+    bool host(unsigned short port);
+    bool join(const std::string& address, unsigned short port);
+
+    void send(const std::vector<uint8_t>& packet) override;
+    bool receive(std::vector<uint8_t>& packet) override;
+
+private:
+    sf::UdpSocket socket;
+    sf::IpAddress peer = sf::IpAddress::None;
+    unsigned short peerPort = 0;
+    uint8_t buffer[sf::UdpSocket::MaxDatagramSize];
+};
@@ -0,0 +1,84 @@
+#include "VoicePool.h"
+
+using namespace std;
+using namespace sf;
+
+SoundEffect VoicePool::addEffect(const ResourceCache<SoundBuffer>::Handle& buffer, int priority, unsigned maxConcurrent) {
+    effects.push_back({ buffer, priority, maxConcurrent });
+    return SoundEffect(effects.size() - 1);
+}
+
+void VoicePool::setBuffer(SoundEffect effect, const ResourceCache<SoundBuffer>::Handle& buffer) {
+    //Voices still pointing at the old buffer have to let go of it first
+    for (auto& voice : voices) {
+        if (voice.effect == effect) {
+            voice.sound.stop();
+            voice.sound.resetBuffer();
+            voice.effect = -1;
+        }
+    }
+    effects[effect].buffer = buffer;
+}
+
+bool VoicePool::play(SoundEffect effect) {
+    const Effect& settings = effects[effect];
+    if (!settings.buffer)
+        return false;
+
+    //One pass finds a free voice, the oldest voice of this effect and the cheapest voice to steal
+    Voice* free = nullptr;
+    Voice* oldestSame = nullptr;
+    Voice* victim = nullptr;
+    unsigned sameCount = 0;
+    for (auto& voice : voices) {
+        if (voice.sound.getStatus() != Sound::Playing) {
+            if (!free)
+                free = &voice;
+            continue;
+        }
+        if (voice.effect == effect) {
+            sameCount++;
+            if (!oldestSame || voice.startedAt < oldestSame->startedAt)
+                oldestSame = &voice;
+        }
+        if (!victim || voice.priority < victim->priority || (voice.priority == victim->priority && voice.startedAt < victim->startedAt))
+            victim = &voice;
+    }
+
+    Voice* voice = nullptr;
+    if (sameCount >= settings.maxConcurrent)
+        voice = oldestSame; //At the cap, restart the oldest copy of itself
+    else if (free)
+        voice = free;
+    else if (victim && victim->priority <= settings.priority)
+        voice = victim;
+
+    if (!voice) {
+        stats.dropped++;
+        return false;
+    }
+    if (voice != free)
+        stats.stolen++;
+
+    voice->sound.stop();
+    if (voice->effect != effect)
+        voice->sound.setBuffer(*settings.buffer);
+    voice->effect = effect;
+    voice->priority = settings.priority;
+    voice->startedAt = ++playCount;
+    voice->sound.play();
+    stats.played++;
+    return true;
+}
+
+void VoicePool::stopAll() {
+    for (auto& voice : voices)
+        voice.sound.stop();
+}
+
+unsigned VoicePool::playing() const {
+    unsigned count = 0;
+    for (const auto& voice : voices)
+        count += voice.sound.getStatus() == Sound::Playing;
+    return count;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Audio.hpp>
+
+#include "ResourceCache.h"
+
+typedef int SoundEffect; //Returned by VoicePool::addEffect
+
+//A fixed set of sf::Sound voices shared by every sound effect. Playing an effect never
+//allocates and never creates an OpenAL source. When every voice is busy the oldest, lowest
+//priority voice is taken over, and each effect can be limited to a few voices at once
+//so thirty enemies firing together don't drown out everything else.
+class VoicePool {
+public:
+    static const unsigned MaxVoices = 24; //Well under OpenAL's source limit, leaving room for the music
+
+    struct Stats {
+        unsigned played = 0;
+        unsigned stolen = 0; //Started by cutting off another sound
+        unsigned dropped = 0; //Nothing it was allowed to take over
+    };
+
+    //Register effects at startup. The buffer can be empty and filled in later with setBuffer().
+    SoundEffect addEffect(const ResourceCache<sf::SoundBuffer>::Handle& buffer, int priority, unsigned maxConcurrent);
+    void setBuffer(SoundEffect effect, const ResourceCache<sf::SoundBuffer>::Handle& buffer);
+    bool hasBuffer(SoundEffect effect) const { return effects[effect].buffer != nullptr; }
+
+    //Returns false if the sound was dropped
+    bool play(SoundEffect effect);
+    void stopAll();
+
+    unsigned playing() const;
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    struct Effect {
+        ResourceCache<sf::SoundBuffer>::Handle buffer;
+        int priority;
+        unsigned maxConcurrent;
+    };
+    struct Voice {
+        sf::Sound sound;
+        SoundEffect effect = -1;
+        int priority = 0;
+        uint64_t startedAt = 0; //Value of playCount when it started, lower is older
+    };
+
+    //Effects are declared first so the voices (and their sf::Sounds) go before the buffers do
+    std::vector<Effect> effects;
+    std::array<Voice, MaxVoices> voices;
+    uint64_t playCount = 0;
+    Stats stats;
+};